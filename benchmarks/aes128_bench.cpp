@@ -0,0 +1,58 @@
+#include "common.h"
+#include <string>
+#include <strings/aes128.h>
+
+static void bench_aes128(bench::Bench& b) {
+    static const std::string input(16 << 10, 'x');
+    static const std::string record(64, 'r');
+    const char iv[16]           = "0123456789abcde";
+    const ss::aes128_key key("secret", 6);
+    const ss::aes128_gcm_key gcm_key(key);
+    std::string out, sealed;
+    ss::aes128_gcm_seal(gcm_key, iv, 12, "", 0, input.data(), input.size(), sealed);
+
+    b.title("aes128 (16KB)").unit("byte").batch(input.size()).relative(true);
+    b.run("ecb", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(ss::aes128_enc(input, key, out));
+    });
+    b.run("ctr", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(ss::aes128_ctr(input, key, iv, out));
+    });
+    b.run("cbc enc", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(ss::aes128_cbc_enc(input, key, iv, out));
+    });
+    b.run("cbc dec", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(ss::aes128_cbc_dec(input, key, iv, out));
+    });
+    b.run("gcm seal", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(
+            ss::aes128_gcm_seal(gcm_key, iv, 12, "", 0, input.data(), input.size(), out));
+    });
+    b.run("gcm open", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(
+            ss::aes128_gcm_open(gcm_key, iv, 12, "", 0, sealed.data(), sealed.size(), out));
+    });
+
+    b.title("aes128 (64B record)").batch(record.size());
+    b.run("ecb(raw key)", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(ss::aes128_enc(record, "secret", out));
+    });
+    b.run("ecb(key)", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(ss::aes128_enc(record, key, out));
+    });
+    b.run("gcm seal", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(
+            ss::aes128_gcm_seal(gcm_key, iv, 12, "", 0, record.data(), record.size(), out));
+    });
+    b.unit("op").batch(1).relative(false);
+}
+BENCHMARK_REGISTE(bench_aes128);
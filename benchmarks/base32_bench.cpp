@@ -0,0 +1,94 @@
+#include "common.h"
+#include <stdexcept>
+#include <string>
+#include <strings/base32.h>
+
+using namespace ss;
+
+// A bit-at-a-time codec, as third-party TOTP code usually has it.
+static std::string base32__marshal(const std::string& what) {
+    static const char* chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    std::string out;
+    uint32_t bits = 0;
+    int nbits     = 0;
+    for (unsigned char c : what) {
+        bits = bits << 8 | c;
+        for (nbits += 8; nbits >= 5; nbits -= 5) {
+            out.push_back(chars[(bits >> (nbits - 5)) & 31]);
+        }
+    }
+    if (nbits > 0) {
+        out.push_back(chars[(bits << (5 - nbits)) & 31]);
+    }
+    while (out.size() % 8 != 0) {
+        out.push_back('=');
+    }
+    return out;
+}
+
+static std::string base32__unmarshal(const std::string& text) {
+    std::string out;
+    uint32_t bits = 0;
+    int nbits     = 0;
+    for (char c : text) {
+        int v;
+        if (c >= 'A' && c <= 'Z') {
+            v = c - 'A';
+        } else if (c >= '2' && c <= '7') {
+            v = c - '2' + 26;
+        } else if (c == '=') {
+            break;
+        } else {
+            throw std::runtime_error("invalid base32");
+        }
+        bits = bits << 5 | v;
+        nbits += 5;
+        if (nbits >= 8) {
+            nbits -= 8;
+            out.push_back((char)(bits >> nbits));
+        }
+    }
+    return out;
+}
+
+static std::string make_input(size_t len) {
+    std::string s;
+    for (size_t i = 0; i < len; ++i) {
+        s.push_back((char)(i * 131 + 7));
+    }
+    return s;
+}
+
+static const base32_options unpadded{base32_alphabet::standard, false, false};
+static const std::string input        = make_input(1000);
+static const std::string input_base32 = base32_encode(input);
+static const std::string secret       = make_input(20);  // a TOTP key
+static const std::string secret_text  = base32_encode(secret, unpadded);
+
+static void bench_base32(bench::Bench& b) {
+    b.title("base32");
+    auto old = b.epochIterations();
+    b.minEpochIterations(20480);
+    std::string out;
+
+    b.run("base32::encode", [&] { bench::doNotOptimizeAway(base32__marshal(input)); });
+    b.run("base32::encode(simd)", [&] { bench::doNotOptimizeAway(base32_encode(input)); });
+    b.run("base32::decode", [&] { bench::doNotOptimizeAway(base32__unmarshal(input_base32)); });
+    b.run("base32::decode(simd)", [&] { bench::doNotOptimizeAway(base32_decode(input_base32)); });
+    b.run("base32hex::encode(simd)", [&] {
+        bench::doNotOptimizeAway(base32_encode(input, {base32_alphabet::hex}));
+    });
+    b.run("base32::validate(simd)", [&] {
+        bench::doNotOptimizeAway(base32_validate(input_base32));
+    });
+    b.run("base32::decode(totp secret)", [&] {
+        bench::doNotOptimizeAway(base32__unmarshal(secret_text));
+    });
+    b.run("base32::decode(simd, totp secret)", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(base32_decode(secret_text, out));
+    });
+
+    b.minEpochIterations(old);
+}
+BENCHMARK_REGISTE(bench_base32);
@@ -0,0 +1,70 @@
+#include "common.h"
+#include <string>
+#include <strings/base58.h>
+#include <vector>
+
+using namespace ss;
+
+// Schoolbook: divide the whole number by 58 once per output digit.
+static std::string base58__marshal(const std::string& in) {
+    static const char* digits = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    std::vector<uint8_t> num(in.begin(), in.end());
+    std::string out;
+    size_t i = 0;
+    for (; i < num.size() && num[i] == 0; ++i) {
+        out.push_back('1');
+    }
+    std::string rev;
+    while (i < num.size()) {
+        uint32_t rem = 0;
+        for (size_t j = i; j < num.size(); ++j) {
+            const uint32_t t = rem << 8 | num[j];
+            num[j]           = t / 58;
+            rem              = t % 58;
+        }
+        rev.push_back(digits[rem]);
+        for (; i < num.size() && num[i] == 0; ++i)
+            ;
+    }
+    return out + std::string(rev.rbegin(), rev.rend());
+}
+
+static std::string make_input(size_t len) {
+    std::string s;
+    for (size_t i = 0; i < len; ++i) {
+        s.push_back((char)(i * 131 + 7));
+    }
+    return s;
+}
+
+static const std::string key       = make_input(32);  // e.g. an ed25519 public key
+static const std::string key_text  = base58_encode(key);
+static const std::string blob      = make_input(256);
+static const std::string blob_text = base58_encode(blob);
+
+static void bench_base58(bench::Bench& b) {
+    b.title("base58");
+    auto old = b.epochIterations();
+    b.minEpochIterations(20480);
+    std::string out;
+
+    b.run("base58::encode(32B, per digit)", [&] {
+        bench::doNotOptimizeAway(base58__marshal(key));
+    });
+    b.run("base58::encode(32B)", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(base58_encode(key, out));
+    });
+    b.run("base58::decode(32B)", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(base58_decode(key_text, out));
+    });
+    b.run("base58::encode(256B, per digit)", [&] {
+        bench::doNotOptimizeAway(base58__marshal(blob));
+    });
+    b.run("base58::encode(256B)", [&] { bench::doNotOptimizeAway(base58_encode(blob)); });
+    b.run("base58::decode(256B)", [&] { bench::doNotOptimizeAway(base58_decode(blob_text)); });
+
+    b.minEpochIterations(old);
+}
+BENCHMARK_REGISTE(bench_base58);
@@ -1,5 +1,8 @@
 #include "common.h"
+#include <algorithm>
+#include <ctype.h>
 #include <stdexcept>
+#include <string_view>
 #include <strings/base64.h>
 
 using namespace ss;
@@ -172,17 +175,118 @@ static const std::string input =
     "aaaaaaaaaaa"
     "aaaa";
 static std::string input_base64 = base64_encode(input);
+static const base64_alphabet crypt(
+    "./0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+static std::string input_crypt = base64_encode(input, {&crypt});
+static std::string input_bad     = input_base64.substr(0, input_base64.size() - 8) + "AAA]AAAA";
+static std::string input_mime    = base64_encode(input, base64_mime);
 
 static void bench_base64(bench::Bench& b) {
     b.title("base64");
     auto old = b.epochIterations();
     b.minEpochIterations(20480);
+    std::string out;
 
     b.run("base64::encode(simd)", [&] { bench::doNotOptimizeAway(base64_encode(input)); });
+    b.run("base64::encode(simd, 100B chunks)", [&] {
+        std::string_view in = input;
+        base64_encoder enc;
+        out.clear();
+        for (size_t i = 0; i < in.size(); i += 100) {
+            enc.update(in.substr(i, 100), out);
+        }
+        enc.final(out);
+        bench::doNotOptimizeAway(out);
+    });
     b.run("base64::encode", [&] { bench::doNotOptimizeAway(base64__marshal(input)); });
     b.run("base64::decode(simd)", [&] { bench::doNotOptimizeAway(base64_decode(input_base64)); });
     b.run("base64::decode", [&] { bench::doNotOptimizeAway(base64__unmarshal(input_base64)); });
+    b.run("base64url::encode(simd + replace)", [&] {
+        out = base64_encode(input);
+        for (auto& c : out) {
+            c = c == '+' ? '-' : c == '/' ? '_' : c;
+        }
+        out.erase(out.find_last_not_of('=') + 1);
+        bench::doNotOptimizeAway(out);
+    });
+    b.run("base64url::encode(simd, unpadded)", [&] {
+        bench::doNotOptimizeAway(base64_encode(input, {&base64_url, base64_padding::forbidden}));
+    });
+    b.run("base64::encode(simd, custom alphabet)", [&] {
+        bench::doNotOptimizeAway(base64_encode(input, {&crypt}));
+    });
+    b.run("base64::decode(simd, custom alphabet)", [&] {
+        bench::doNotOptimizeAway(base64_decode(input_crypt, {&crypt}));
+    });
+    b.run("base64::validate(simd)", [&] {
+        bench::doNotOptimizeAway(base64_validate(input_base64));
+    });
+    b.run("base64::decode(simd, malformed, catch)", [&] {
+        out.clear();
+        try {
+            base64_decode(input_bad, out);
+        } catch (const input_error& e) {
+            bench::doNotOptimizeAway(e.offset());
+        }
+    });
+    b.run("base64::try_decode(simd, malformed)", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(try_base64_decode(input_bad, out));
+    });
+
+    b.run("base64::encode(simd, mime, insert breaks after)", [&] {
+        out = base64_encode(input);
+        for (size_t i = 76; i < out.size(); i += 78) {
+            out.insert(i, "\r\n");
+        }
+        bench::doNotOptimizeAway(out);
+    });
+    b.run("base64::encode(simd, mime)", [&] {
+        bench::doNotOptimizeAway(base64_encode(input, base64_mime));
+    });
+    b.run("base64::decode(simd, mime, strip spaces first)", [&] {
+        out = input_mime;
+        out.erase(std::remove_if(out.begin(), out.end(), [](char c) { return isspace(c); }),
+                  out.end());
+        bench::doNotOptimizeAway(base64_decode(out));
+    });
+    b.run("base64::decode(simd, mime)", [&] {
+        bench::doNotOptimizeAway(base64_decode(input_mime, base64_mime));
+    });
 
     b.minEpochIterations(old);
 }
 BENCHMARK_REGISTE(bench_base64);
+
+// A multi-MB PEM body written and read back 64 KiB at a time.
+static void bench_base64_pem(bench::Bench& b) {
+    b.title("base64 pem");
+    std::string plain;
+    while (plain.size() < (4 << 20)) {
+        plain += input;
+    }
+    const std::string pem   = base64_encode(plain, base64_pem);
+    constexpr size_t kChunk = 64 << 10;
+    std::string out;
+    out.reserve(pem.size());
+
+    b.run("base64::encoder(pem, 64K chunks)", [&] {
+        base64_encoder enc(base64_pem);
+        out.clear();
+        for (size_t i = 0; i < plain.size(); i += kChunk) {
+            enc.update(std::string_view(plain).substr(i, kChunk), out);
+        }
+        enc.final(out);
+        bench::doNotOptimizeAway(out);
+    });
+    b.run("base64::decoder(pem, 64K chunks)", [&] {
+        base64_decoder dec(base64_pem);
+        out.clear();
+        for (size_t i = 0; i < pem.size(); i += kChunk) {
+            dec.update(std::string_view(pem).substr(i, kChunk), out);
+        }
+        dec.final();
+        bench::doNotOptimizeAway(out);
+    });
+}
+BENCHMARK_REGISTE(bench_base64_pem);
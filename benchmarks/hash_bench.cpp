@@ -1,6 +1,9 @@
 #include "common.h"
+#include <strings/hmac.h>
 #include <strings/md5.h>
 #include <strings/sha1.h>
+#include <string_view>
+#include <vector>
 #include <xxh3.h>
 
 static const std::string input =
@@ -37,11 +40,59 @@ static void bench_md5(bench::Bench& b) {
     b.title("md5");
     auto old = b.epochIterations();
     b.minEpochIterations(2048);
+    const ss::hmac_sha1_key key("secret");
 
     b.run("md5", [&] { bench::doNotOptimizeAway(ss::md5sum(input)); });
     b.run("sha1", [&] { bench::doNotOptimizeAway(ss::sha1sum(input)); });
+    b.run("hmac_sha1", [&] { bench::doNotOptimizeAway(ss::hmac_sha1("secret", input)); });
+    b.run("hmac_sha1(key)", [&] { bench::doNotOptimizeAway(ss::hmac_sha1(key, input)); });
     b.run("xxh3", [&] { bench::doNotOptimizeAway(XXH3_64bits(input.data(), input.size())); });
 
     b.minEpochIterations(old);
 }
 BENCHMARK_REGISTE(bench_md5);
+
+static void bench_sha1_backends(bench::Bench& b) {
+    static const std::string large(1 << 20, 'x');
+    const std::string saved = ss::sha1_backend();
+
+    b.title("sha1 backends (1MB)").unit("byte").batch(large.size()).relative(true);
+    for (const char* name : {"scalar", "sha-ni", "armv8"}) {
+        if (ss::sha1_set_backend(name)) {
+            b.run(name, [&] { bench::doNotOptimizeAway(ss::sha1(large)); });
+        }
+    }
+    b.unit("op").batch(1).relative(false);
+    ss::sha1_set_backend(saved.c_str());
+}
+BENCHMARK_REGISTE(bench_sha1_backends);
+
+static void bench_hash_many(bench::Bench& b) {
+    static const std::string pool(1024, 'k');
+    std::vector<std::string_view> keys;
+    for (size_t i = 0; i < 1024; ++i) {
+        keys.emplace_back(pool.data() + i % 64, 50 + (i * 37) % 450);
+    }
+    std::string out;
+
+    b.title("hash many (1024 keys, 50-500B)");
+    b.run("md5 x N", [&] {
+        out.clear();
+        for (auto k : keys) ss::md5(k, out);
+        bench::doNotOptimizeAway(out);
+    });
+    b.run("md5_many", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(ss::md5_many(keys, out));
+    });
+    b.run("sha1 x N", [&] {
+        out.clear();
+        for (auto k : keys) ss::sha1(k, out);
+        bench::doNotOptimizeAway(out);
+    });
+    b.run("sha1_many", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(ss::sha1_many(keys, out));
+    });
+}
+BENCHMARK_REGISTE(bench_hash_many);
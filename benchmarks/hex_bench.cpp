@@ -1,5 +1,6 @@
 #include "common.h"
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <strings/hex.h>
 
@@ -88,11 +89,31 @@ static void bench_hex(bench::Bench& b) {
     b.title("hex");
     auto old = b.epochIterations();
     b.minEpochIterations(40960);
+    std::string out;
 
     b.run("hex::encode(simd)", [&] { bench::doNotOptimizeAway(hex_encode(input)); });
+    b.run("hex::encode(simd, reuse)", [&] {
+        out.clear();
+        bench::doNotOptimizeAway(hex_encode(input, out));
+    });
     b.run("hex::encode", [&] { bench::doNotOptimizeAway(hex_marshal(input)); });
     b.run("hex::decode(simd)", [&] { bench::doNotOptimizeAway(hex_decode(input_hex)); });
     b.run("hex::decode", [&] { bench::doNotOptimizeAway(hex_unmarshal(input_hex)); });
+    b.run("hex::validate(simd)", [&] { bench::doNotOptimizeAway(hex_validate(input_hex)); });
+
+    // digest and UUID sized inputs are all tail
+    char buf[200];
+    for (size_t len : {16, 32, 64}) {
+        const std::string_view small(input.data(), len);
+        const std::string n = std::to_string(len);
+        b.run("hex::encode(" + n + ")", [&] { bench::doNotOptimizeAway(hex_marshal(small)); });
+        b.run("hex::encode(simd, " + n + ")", [&] {
+            bench::doNotOptimizeAway(hex_encode(small, buf, sizeof(buf)));
+        });
+        b.run("hex::encode(simd, " + n + ", upper+sep)", [&] {
+            bench::doNotOptimizeAway(hex_encode(small, {true, ':'}, buf, sizeof(buf)));
+        });
+    }
 
     b.minEpochIterations(old);
 }
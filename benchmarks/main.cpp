@@ -1,6 +1,9 @@
 #include "common.h"
+#include <stdio.h>
+#include <strings/object.h>
 
 int main() {
+    printf("simd target: %s\n", ss::active_target());
     BenchRegistry::get().run();
     return 0;
 }
@@ -0,0 +1,66 @@
+#include "common.h"
+#include <stdlib.h>
+#include <string>
+#include <string_view>
+#include <strings/core.h>
+#include <strings/numbers.h>
+#include <vector>
+
+static std::string make_column(size_t count) {
+    std::string column;
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < count; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        column += (i ? "," : "") + std::to_string((int64_t)(x >> (x % 48)) - 1000);
+    }
+    return column;
+}
+
+static const std::string column = make_column(1000);
+
+static void bench_numbers(bench::Bench& b) {
+    b.title("numbers");
+    auto old = b.epochIterations();
+    b.minEpochIterations(10240);
+
+    const std::string_view field = "-1234567890";
+    b.run("std::stoll(copy)", [&] { bench::doNotOptimizeAway(std::stoll(std::string(field))); });
+    b.run("parse_int", [&] { bench::doNotOptimizeAway(ss::parse_int<int64_t>(field)); });
+
+    const std::string_view real = "-12345.678901e-3";
+    b.run("strtod(copy)", [&] {
+        bench::doNotOptimizeAway(strtod(std::string(real).c_str(), nullptr));
+    });
+    b.run("parse_float", [&] { bench::doNotOptimizeAway(ss::parse_float(real)); });
+
+    char buf[ss::format_float_max_size];
+    b.run("std::to_string(int)", [&] { bench::doNotOptimizeAway(std::to_string(-1234567890)); });
+    b.run("format_int", [&] { bench::doNotOptimizeAway(ss::format_int(-1234567890, buf, 24)); });
+    b.run("snprintf(%.17g)", [&] {
+        bench::doNotOptimizeAway(snprintf(buf, sizeof(buf), "%.17g", 0.1 + 0.2));
+    });
+    b.run("format_float", [&] {
+        bench::doNotOptimizeAway(ss::format_float(0.1 + 0.2, buf, sizeof(buf)));
+    });
+
+    std::vector<std::string_view> fields;
+    std::vector<int64_t> values;
+    std::vector<ss::column_error> errors;
+    b.run("column: split + stoll", [&] {
+        values.clear();
+        ss::str_split_into(column, ",", fields);
+        for (auto f : fields) {
+            values.push_back(std::stoll(std::string(f)));
+        }
+        bench::doNotOptimizeAway(values);
+    });
+    b.run("column: parse_int_column", [&] {
+        bench::doNotOptimizeAway(ss::parse_int_column(column, ',', values, errors));
+    });
+
+    b.minEpochIterations(old);
+}
+
+BENCHMARK_REGISTE(bench_numbers);
@@ -1,6 +1,8 @@
 #include "common.h"
 #include <algorithm>
+#include <string.h>
 #include <string_view>
+#include <vector>
 #include <strings/core.h>
 
 inline char tolower0(char c) {
@@ -94,10 +96,101 @@ static void bench_string(bench::Bench& b) {
         bench::doNotOptimizeAway(
             ss::str_toupper("aabcdefghijklabcdefghijklbcdefgh0abcdefghijklabc"));
     });
+    b.run("toupper_inplace(simd)", [&] {
+        std::string header = "content-type-with-some-longer-name";
+        ss::str_toupper_inplace(header);
+        bench::doNotOptimizeAway(header);
+    });
     b.run("tolower", [&] { bench::doNotOptimizeAway(str_tolower0(input)); });
     b.run("tolower(simd)", [&] { bench::doNotOptimizeAway(ss::str_tolower(input)); });
+    b.run("str_iequals", [&] { bench::doNotOptimizeAway(ss::str_iequals(input, input)); });
+    b.run("str_ifind", [&] { bench::doNotOptimizeAway(ss::str_ifind(input, "AAAA,")); });
+    b.run("str_ihash", [&] { bench::doNotOptimizeAway(ss::str_ihash(input)); });
     b.run("str_split", [&] { bench::doNotOptimizeAway(ss::str_split(input, ",")); });
+    std::vector<std::string_view> fields;
+    b.run("str_split_into", [&] {
+        bench::doNotOptimizeAway(ss::str_split_into(input, ",", fields));
+    });
+    b.run("str_split_into(trim)", [&] {
+        bench::doNotOptimizeAway(ss::str_split_into(input, ",", fields, true));
+    });
+    b.run("str_trim", [&] {
+        bench::doNotOptimizeAway(ss::str_trim("   \t padded field of a csv line \r\n"));
+    });
+    b.run("split_view", [&] {
+        size_t n = 0;
+        for (auto f : ss::split_view(input, ",")) {
+            n += f.size();
+        }
+        bench::doNotOptimizeAway(n);
+    });
+    static const ss::charset seps(",;= \t");
+    b.run("str_find_first_of", [&] {
+        bench::doNotOptimizeAway(input_sv.find_first_of(",;= \t", 300));
+    });
+    b.run("str_find_first_of(simd)", [&] {
+        bench::doNotOptimizeAway(ss::str_find_first_of(input, seps, 300));
+    });
+    b.run("str_split_any", [&] {
+        bench::doNotOptimizeAway(ss::str_split_any_into(input, seps, fields));
+    });
+    // needle at the end of the input, as in a miss-mostly filter
+    for (std::string_view needle : {input_sv.substr(input.size() - 24, 12),
+                                    input_sv.substr(input.size() - 100, 80)}) {
+        const ss::searcher sr(needle);
+        const auto name = std::to_string(needle.size());
+        b.run("memmem-" + name, [&] {
+            bench::doNotOptimizeAway(
+                memmem(input.data(), input.size(), needle.data(), needle.size()));
+        });
+        b.run("searcher.find-" + name, [&] { bench::doNotOptimizeAway(sr.find(input)); });
+        b.run("searcher.count-" + name, [&] { bench::doNotOptimizeAway(sr.count(input)); });
+    }
+    // keywords that mostly miss, as in a log filter
+    for (size_t npat : {50, 300}) {
+        std::vector<std::string> words;
+        for (size_t i = 0; i < npat; ++i) {
+            words.push_back("kw" + std::to_string(i * 7919) + (i % 2 ? "-err" : "-warn"));
+        }
+        const ss::multi_searcher ms(std::vector<std::string_view>(words.begin(), words.end()));
+        const auto name = std::to_string(npat);
+        b.run("str_find-loop-" + name, [&] {
+            size_t n = 0;
+            for (const auto& w : words) {
+                n += ss::str_find(input, w) != std::string_view::npos;
+            }
+            bench::doNotOptimizeAway(n);
+        });
+        b.run("multi_searcher-" + name, [&] {
+            size_t n = 0;
+            ms.find_all(input, [&](size_t, size_t) { ++n; });
+            bench::doNotOptimizeAway(n);
+        });
+    }
+    b.run("str_replace_byte", [&] {
+        bench::doNotOptimizeAway(ss::str_replace_byte(input, ',', ';'));
+    });
+    b.run("str_remove_bytes", [&] {
+        bench::doNotOptimizeAway(ss::str_remove_bytes(input, seps));
+    });
+    b.run("replace-loop", [&] {
+        std::string out(input);
+        for (size_t p = out.find(','); p != std::string::npos; p = out.find(',', p + 3)) {
+            out.replace(p, 1, "%2C");
+        }
+        bench::doNotOptimizeAway(out);
+    });
+    b.run("str_replace_all", [&] {
+        bench::doNotOptimizeAway(ss::str_replace_all(input, ",", "%2C"));
+    });
     b.run("str_join", [&] { bench::doNotOptimizeAway(ss::str_join(splitted, ",")); });
+    const std::string host = "example.com", path = "/index.html";
+    b.run("operator+", [&] {
+        bench::doNotOptimizeAway("https://" + host + ":" + "443" + path + "?q=1");
+    });
+    b.run("str_concat", [&] {
+        bench::doNotOptimizeAway(ss::str_concat("https://", host, ':', "443", path, "?q=1"));
+    });
 
     b.minEpochIterations(old);
 }
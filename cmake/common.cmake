@@ -17,11 +17,11 @@ set(BUILD_SHARED_LIBS OFF)
 
 # being a cross-platform target, we enforce standards conformance on MSVC all compile:
 # https://cmake.org/cmake/help/latest/variable/CMAKE_LANG_COMPILER_ID.html
+# SIMD targets are selected at runtime (see HWY_DYNAMIC_DISPATCH), so there is
+# no -march=native here: the library stays portable across the fleet.
 if (LINUX)
-  if (NOT CMAKE_CROSSCOMPILING)
-    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -march=native -Wno-narrowing")
-    set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -march=native -Wno-narrowing")
-  endif()
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wno-narrowing")
+  set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -Wno-narrowing")
 elseif(MSVC)
   set(CMAKE_C_FLAGS "${CMAKE_CXX_FLAGS} /permissive-")
   set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} /permissive-")
@@ -1,17 +1,250 @@
 #pragma once
 
+#include <string>
+#include <utility>
 #include <vector>
 #include <stdint.h>
 #include <strings/object.h>
 
 namespace ss {
 
+// Expanded encryption and decryption round keys. Build it once per key and reuse
+// it across calls; it is immutable, so a const instance can be shared between
+// threads. Keys shorter than 16 bytes are zero-padded, longer ones truncated.
+class aes128_key {
+public:
+    aes128_key(const char* key, size_t key_size);
+
+    template <typename Tk, typename Dummy = decltype(to_span(std::declval<Tk>()))>
+    explicit aes128_key(const Tk& key) : aes128_key(to_span(key).data(), to_span(key).size()) {}
+
+    // 20 x 16 bytes: encryption rounds 0..10, then decryption rounds 1..9.
+    const uint8_t* round_keys() const { return round_keys_; }
+
+private:
+    alignas(16) uint8_t round_keys_[20 * 16];
+};
+
+std::vector<uint8_t> aes128_enc(const char* plain, size_t plain_size, const aes128_key& key);
+std::vector<uint8_t> aes128_dec(const char* cipher, size_t cipher_size, const aes128_key& key);
+size_t aes128_enc(const char* plain, size_t plain_size, const aes128_key& key, char* out,
+                  size_t cap);
+size_t aes128_dec(const char* cipher, size_t cipher_size, const aes128_key& key, char* out,
+                  size_t cap);
+size_t aes128_enc(const char* plain, size_t plain_size, const aes128_key& key,
+                  std::string& out);
+size_t aes128_dec(const char* cipher, size_t cipher_size, const aes128_key& key,
+                  std::string& out);
+
 std::vector<uint8_t>
 aes128_enc(const char* plain, size_t plain_size, const char* key, size_t key_size);
 
 std::vector<uint8_t>
 aes128_dec(const char* cipher, size_t cipher_size, const char* key, size_t key_size);
 
+// Write into `out` (at least aes128_xxx_size() bytes), return the bytes written.
+size_t aes128_enc(const char* plain, size_t plain_size, const char* key, size_t key_size,
+                  char* out, size_t cap);
+size_t aes128_dec(const char* cipher, size_t cipher_size, const char* key, size_t key_size,
+                  char* out, size_t cap);
+
+// Append to `out`, return the bytes appended.
+size_t aes128_enc(const char* plain, size_t plain_size, const char* key, size_t key_size,
+                  std::string& out);
+size_t aes128_dec(const char* cipher, size_t cipher_size, const char* key, size_t key_size,
+                  std::string& out);
+
+// PKCS#7 always adds 1..16 bytes.
+inline size_t aes128_enc_size(const char* plain, size_t plain_size) {
+    return (plain_size / 16 + 1) * 16;
+}
+
+// Upper bound, the padding is only known after decryption.
+inline size_t aes128_dec_size(const char* cipher, size_t cipher_size) {
+    return cipher_size;
+}
+
+// Raw block modes, no padding. `iv` is 16 bytes, `out` receives exactly `len`
+// bytes and may be the same buffer as `in`.
+//
+// CTR treats `iv` as a 128-bit big-endian counter; encryption and decryption are
+// the same operation.
+void aes128_ctr(const char* in, size_t len, const aes128_key& key, const char* iv, char* out);
+size_t aes128_ctr(const char* in, size_t len, const aes128_key& key, const char* iv,
+                  std::string& out);
+void aes128_ctr(const char* in, size_t len, const char* key, size_t key_size, const char* iv,
+                char* out);
+size_t aes128_ctr(const char* in, size_t len, const char* key, size_t key_size, const char* iv,
+                  std::string& out);
+
+// CBC requires `len` to be a multiple of 16.
+void aes128_cbc_enc(const char* in, size_t len, const aes128_key& key, const char* iv,
+                    char* out);
+void aes128_cbc_dec(const char* in, size_t len, const aes128_key& key, const char* iv,
+                    char* out);
+size_t aes128_cbc_enc(const char* in, size_t len, const aes128_key& key, const char* iv,
+                      std::string& out);
+size_t aes128_cbc_dec(const char* in, size_t len, const aes128_key& key, const char* iv,
+                      std::string& out);
+void aes128_cbc_enc(const char* in, size_t len, const char* key, size_t key_size,
+                    const char* iv, char* out);
+void aes128_cbc_dec(const char* in, size_t len, const char* key, size_t key_size,
+                    const char* iv, char* out);
+size_t aes128_cbc_enc(const char* in, size_t len, const char* key, size_t key_size,
+                      const char* iv, std::string& out);
+size_t aes128_cbc_dec(const char* in, size_t len, const char* key, size_t key_size,
+                      const char* iv, std::string& out);
+
+// CTR over a stream of arbitrarily sized chunks, the output is the same as one
+// aes128_ctr() call over their concatenation.
+class aes128_ctr_stream {
+public:
+    aes128_ctr_stream(const aes128_key& key, const char* iv);
+    aes128_ctr_stream(const char* key, size_t key_size, const char* iv);
+
+    template <typename Tk, typename Dummy = decltype(to_span(std::declval<Tk>()))>
+    aes128_ctr_stream(const Tk& key, const char* iv)
+      : aes128_ctr_stream(to_span(key).data(), to_span(key).size(), iv) {}
+
+    // `out` receives `len` bytes and may be the same buffer as `in`.
+    void update(const char* in, size_t len, char* out);
+    // Append to `out`, return the bytes appended.
+    size_t update(const char* in, size_t len, std::string& out);
+
+    template <typename V>
+    size_t update(const V& v, std::string& out) {
+        auto s = to_span(v);
+        return update(s.data(), s.size(), out);
+    }
+
+private:
+    aes128_key key_;
+    uint8_t ctr_[16];
+    uint8_t keystream_[16];
+    size_t nkeystream_;  // unused bytes at the end of keystream_
+};
+
+inline constexpr size_t aes128_gcm_tag_size = 16;
+
+// An aes128_key plus the GHASH key powers, reusable and shareable like aes128_key.
+class aes128_gcm_key {
+public:
+    explicit aes128_gcm_key(const aes128_key& key);
+    aes128_gcm_key(const char* key, size_t key_size);
+
+    template <typename Tk, typename Dummy = decltype(to_span(std::declval<Tk>()))>
+    explicit aes128_gcm_key(const Tk& key)
+      : aes128_gcm_key(to_span(key).data(), to_span(key).size()) {}
+
+    const aes128_key& key() const { return key_; }
+    const uint8_t* htable() const { return htable_; }
+
+private:
+    aes128_key key_;
+    alignas(16) uint8_t htable_[20 * 16];
+};
+
+// AES-128-GCM. seal() writes the ciphertext followed by the 16-byte tag; open()
+// takes that layout, writes the plaintext and throws std::runtime_error if the tag
+// does not match (the output is zeroed first). Any non-empty IV is accepted, 12
+// bytes is the recommended size; an empty IV throws std::runtime_error.
+size_t aes128_gcm_seal(const aes128_gcm_key& key, const char* iv, size_t iv_size,
+                       const char* aad, size_t aad_size, const char* plain, size_t plain_size,
+                       char* out, size_t cap);
+size_t aes128_gcm_open(const aes128_gcm_key& key, const char* iv, size_t iv_size,
+                       const char* aad, size_t aad_size, const char* cipher, size_t cipher_size,
+                       char* out, size_t cap);
+
+// Append to `out`, return the bytes appended.
+size_t aes128_gcm_seal(const aes128_gcm_key& key, const char* iv, size_t iv_size,
+                       const char* aad, size_t aad_size, const char* plain, size_t plain_size,
+                       std::string& out);
+size_t aes128_gcm_open(const aes128_gcm_key& key, const char* iv, size_t iv_size,
+                       const char* aad, size_t aad_size, const char* cipher, size_t cipher_size,
+                       std::string& out);
+
+inline size_t aes128_gcm_seal_size(const char* plain, size_t plain_size) {
+    return plain_size + aes128_gcm_tag_size;
+}
+
+inline size_t aes128_gcm_open_size(const char* cipher, size_t cipher_size) {
+    return cipher_size < aes128_gcm_tag_size ? 0 : cipher_size - aes128_gcm_tag_size;
+}
+
+// Shared state of the streaming GCM objects. The key is referenced, not copied,
+// and must outlive the stream. All aad() calls must come before the text, a
+// later one throws std::logic_error.
+class aes128_gcm_stream {
+public:
+    void aad(const char* buf, size_t len);
+
+    template <typename V>
+    void aad(const V& v) {
+        auto s = to_span(v);
+        aad(s.data(), s.size());
+    }
+
+protected:
+    aes128_gcm_stream(const aes128_gcm_key& key, const char* iv, size_t iv_size);
+
+    void crypt(const char* in, size_t len, char* out, bool decrypt);
+    void compute_tag(uint8_t* tag);
+
+private:
+    void hash_pending();
+
+    const aes128_gcm_key* key_;
+    uint8_t j0_[16];
+    uint8_t ctr_[16];
+    uint8_t ghash_[16];      // byte-reflected running GHASH
+    uint8_t pending_[16];    // partial block not hashed yet
+    uint8_t keystream_[16];  // keystream of the partial text block
+    size_t npending_;
+    uint64_t aad_size_;
+    uint64_t text_size_;
+    bool text_started_;  // update() was called, even with no bytes
+};
+
+class aes128_gcm_sealer : public aes128_gcm_stream {
+public:
+    aes128_gcm_sealer(const aes128_gcm_key& key, const char* iv, size_t iv_size)
+      : aes128_gcm_stream(key, iv, iv_size) {}
+
+    // `out` receives `len` bytes and may be the same buffer as `in`.
+    void update(const char* in, size_t len, char* out) { crypt(in, len, out, false); }
+    // Append to `out`, return the bytes appended.
+    size_t update(const char* in, size_t len, std::string& out);
+
+    // Write the tag (at least aes128_gcm_tag_size bytes), return the bytes written.
+    size_t final(char* tag, size_t cap);
+    size_t final(std::string& out);
+
+    template <typename V>
+    size_t update(const V& v, std::string& out) {
+        auto s = to_span(v);
+        return update(s.data(), s.size(), out);
+    }
+};
+
+class aes128_gcm_opener : public aes128_gcm_stream {
+public:
+    aes128_gcm_opener(const aes128_gcm_key& key, const char* iv, size_t iv_size)
+      : aes128_gcm_stream(key, iv, iv_size) {}
+
+    // The plaintext is not authentic until final() returns.
+    void update(const char* in, size_t len, char* out) { crypt(in, len, out, true); }
+    size_t update(const char* in, size_t len, std::string& out);
+
+    // Throws std::runtime_error if `tag` does not match.
+    void final(const char* tag, size_t tag_size);
+
+    template <typename V>
+    size_t update(const V& v, std::string& out) {
+        auto s = to_span(v);
+        return update(s.data(), s.size(), out);
+    }
+};
+
 template <typename Tp, typename Tk>
 std::vector<uint8_t>  //
 aes128_enc(const Tp& plain, const Tk& key) {
@@ -28,4 +261,126 @@ aes128_dec(const Tp& plain, const Tk& key) {
     return aes128_dec(p.data(), p.size(), k.data(), k.size());
 }
 
+// `Dummy` keeps (char* plain, size_t, char* key, size_t) calls on the pointer overload.
+template <typename Tp, typename Tk, typename Dummy = decltype(to_span(std::declval<Tk>()))>
+size_t aes128_enc(const Tp& plain, const Tk& key, char* out, size_t cap) {
+    auto p = to_span(plain);
+    auto k = to_span(key);
+    return aes128_enc(p.data(), p.size(), k.data(), k.size(), out, cap);
+}
+
+template <typename Tp, typename Tk, typename Dummy = decltype(to_span(std::declval<Tk>()))>
+size_t aes128_dec(const Tp& cipher, const Tk& key, char* out, size_t cap) {
+    auto c = to_span(cipher);
+    auto k = to_span(key);
+    return aes128_dec(c.data(), c.size(), k.data(), k.size(), out, cap);
+}
+
+template <typename Tp, typename Tk>
+size_t aes128_enc(const Tp& plain, const Tk& key, std::string& out) {
+    auto p = to_span(plain);
+    auto k = to_span(key);
+    return aes128_enc(p.data(), p.size(), k.data(), k.size(), out);
+}
+
+template <typename Tp, typename Tk>
+size_t aes128_dec(const Tp& cipher, const Tk& key, std::string& out) {
+    auto c = to_span(cipher);
+    auto k = to_span(key);
+    return aes128_dec(c.data(), c.size(), k.data(), k.size(), out);
+}
+
+template <typename Tp, typename Tk>
+size_t aes128_ctr(const Tp& in, const Tk& key, const char* iv, std::string& out) {
+    auto p = to_span(in);
+    auto k = to_span(key);
+    return aes128_ctr(p.data(), p.size(), k.data(), k.size(), iv, out);
+}
+
+template <typename Tp, typename Tk>
+size_t aes128_cbc_enc(const Tp& plain, const Tk& key, const char* iv, std::string& out) {
+    auto p = to_span(plain);
+    auto k = to_span(key);
+    return aes128_cbc_enc(p.data(), p.size(), k.data(), k.size(), iv, out);
+}
+
+template <typename Tp, typename Tk>
+size_t aes128_cbc_dec(const Tp& cipher, const Tk& key, const char* iv, std::string& out) {
+    auto c = to_span(cipher);
+    auto k = to_span(key);
+    return aes128_cbc_dec(c.data(), c.size(), k.data(), k.size(), iv, out);
+}
+
+template <typename Tp>
+std::vector<uint8_t> aes128_enc(const Tp& plain, const aes128_key& key) {
+    auto p = to_span(plain);
+    return aes128_enc(p.data(), p.size(), key);
+}
+
+template <typename Tp>
+std::vector<uint8_t> aes128_dec(const Tp& cipher, const aes128_key& key) {
+    auto c = to_span(cipher);
+    return aes128_dec(c.data(), c.size(), key);
+}
+
+template <typename Tp>
+size_t aes128_enc(const Tp& plain, const aes128_key& key, char* out, size_t cap) {
+    auto p = to_span(plain);
+    return aes128_enc(p.data(), p.size(), key, out, cap);
+}
+
+template <typename Tp>
+size_t aes128_dec(const Tp& cipher, const aes128_key& key, char* out, size_t cap) {
+    auto c = to_span(cipher);
+    return aes128_dec(c.data(), c.size(), key, out, cap);
+}
+
+template <typename Tp>
+size_t aes128_enc(const Tp& plain, const aes128_key& key, std::string& out) {
+    auto p = to_span(plain);
+    return aes128_enc(p.data(), p.size(), key, out);
+}
+
+template <typename Tp>
+size_t aes128_dec(const Tp& cipher, const aes128_key& key, std::string& out) {
+    auto c = to_span(cipher);
+    return aes128_dec(c.data(), c.size(), key, out);
+}
+
+template <typename Tp>
+size_t aes128_ctr(const Tp& in, const aes128_key& key, const char* iv, std::string& out) {
+    auto p = to_span(in);
+    return aes128_ctr(p.data(), p.size(), key, iv, out);
+}
+
+template <typename Tp>
+size_t aes128_cbc_enc(const Tp& plain, const aes128_key& key, const char* iv, std::string& out) {
+    auto p = to_span(plain);
+    return aes128_cbc_enc(p.data(), p.size(), key, iv, out);
+}
+
+template <typename Tp>
+size_t aes128_cbc_dec(const Tp& cipher, const aes128_key& key, const char* iv, std::string& out) {
+    auto c = to_span(cipher);
+    return aes128_cbc_dec(c.data(), c.size(), key, iv, out);
+}
+
+template <typename Tv, typename Ta, typename Tp>
+size_t aes128_gcm_seal(const aes128_gcm_key& key, const Tv& iv, const Ta& aad, const Tp& plain,
+                       std::string& out) {
+    auto v = to_span(iv);
+    auto a = to_span(aad);
+    auto p = to_span(plain);
+    return aes128_gcm_seal(key, v.data(), v.size(), a.data(), a.size(), p.data(), p.size(), out);
+}
+
+template <typename Tv, typename Ta, typename Tc>
+size_t aes128_gcm_open(const aes128_gcm_key& key, const Tv& iv, const Ta& aad, const Tc& cipher,
+                       std::string& out) {
+    auto v = to_span(iv);
+    auto a = to_span(aad);
+    auto c = to_span(cipher);
+    return aes128_gcm_open(key, v.data(), v.size(), a.data(), a.size(), c.data(), c.size(), out);
+}
+
 }  // namespace ss
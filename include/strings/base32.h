@@ -0,0 +1,197 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <strings/object.h>
+
+namespace ss {
+
+// RFC 4648: "A-Z2-7", or base32hex "0-9A-V" which keeps the sort order of the
+// data, e.g. for DNSSEC NSEC3 labels.
+enum class base32_alphabet : uint8_t { standard, hex };
+
+struct base32_options {
+    base32_alphabet alphabet = base32_alphabet::standard;
+    bool lower               = false;  // encode in lower case; decode accepts either
+    bool padding             = true;   // encode pads to a multiple of 8 chars
+};
+
+// Decode accepts padded and unpadded text, in either case, e.g. TOTP secrets.
+std::string base32_encode(const char* buf, size_t len);
+std::string base32_decode(const char* buf, size_t len);
+
+// Write into `out` (at least base32_xxx_size() bytes), return the bytes written.
+size_t base32_encode(const char* buf, size_t len, char* out, size_t cap);
+size_t base32_decode(const char* buf, size_t len, char* out, size_t cap);
+
+// Append to `out`, return the bytes appended.
+size_t base32_encode(const char* buf, size_t len, std::string& out);
+size_t base32_decode(const char* buf, size_t len, std::string& out);
+
+// Decode without throwing: bad input is reported in the result and leaves an
+// appended `out` as it was.
+decode_result try_base32_decode(const char* buf, size_t len, char* out, size_t cap);
+decode_result try_base32_decode(const char* buf, size_t len, std::string& out);
+// Check `buf` the way base32_decode() would, writing nothing.
+decode_result base32_validate(const char* buf, size_t len);
+
+// base32hex, lower case or unpadded output.
+std::string base32_encode(const char* buf, size_t len, const base32_options& opts);
+std::string base32_decode(const char* buf, size_t len, const base32_options& opts);
+size_t base32_encode(const char* buf, size_t len, const base32_options& opts, char* out,
+                     size_t cap);
+size_t base32_decode(const char* buf, size_t len, const base32_options& opts, char* out,
+                     size_t cap);
+size_t base32_encode(const char* buf, size_t len, const base32_options& opts, std::string& out);
+size_t base32_decode(const char* buf, size_t len, const base32_options& opts, std::string& out);
+decode_result try_base32_decode(const char* buf, size_t len, const base32_options& opts,
+                                char* out, size_t cap);
+decode_result try_base32_decode(const char* buf, size_t len, const base32_options& opts,
+                                std::string& out);
+decode_result base32_validate(const char* buf, size_t len, const base32_options& opts);
+
+inline size_t base32_encode_size(const char* buf, size_t len) {
+    return (len + 4) / 5 * 8;
+}
+
+inline size_t base32_encode_size(const char* buf, size_t len, const base32_options& opts) {
+    return opts.padding ? base32_encode_size(buf, len) : (len * 8 + 4) / 5;
+}
+
+// Exact for valid text, padded or not.
+inline size_t base32_decode_size(const char* buf, size_t len) {
+    size_t padding = 0;
+    for (int i = len - 1; i >= 0 && buf[i] == '=' && padding < 6; --i, ++padding)
+        ;
+    const size_t n = len - padding;
+    return n / 8 * 5 + n % 8 * 5 / 8;
+}
+
+template <typename V>
+std::string base32_encode(const V& v) {
+    auto s = to_span(v);
+    return base32_encode(s.data(), s.size());
+}
+
+template <typename V>
+std::string base32_decode(const V& v) {
+    auto s = to_span(v);
+    return base32_decode(s.data(), s.size());
+}
+
+template <typename V>
+size_t base32_encode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base32_encode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t base32_decode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base32_decode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t base32_encode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return base32_encode(s.data(), s.size(), out);
+}
+
+template <typename V>
+size_t base32_decode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return base32_decode(s.data(), s.size(), out);
+}
+
+template <typename V>
+decode_result try_base32_decode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return try_base32_decode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+decode_result try_base32_decode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return try_base32_decode(s.data(), s.size(), out);
+}
+
+template <typename V>
+decode_result base32_validate(const V& v) {
+    auto s = to_span(v);
+    return base32_validate(s.data(), s.size());
+}
+
+template <typename V>
+std::string base32_encode(const V& v, const base32_options& opts) {
+    auto s = to_span(v);
+    return base32_encode(s.data(), s.size(), opts);
+}
+
+template <typename V>
+std::string base32_decode(const V& v, const base32_options& opts) {
+    auto s = to_span(v);
+    return base32_decode(s.data(), s.size(), opts);
+}
+
+template <typename V>
+size_t base32_encode(const V& v, const base32_options& opts, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base32_encode(s.data(), s.size(), opts, out, cap);
+}
+
+template <typename V>
+size_t base32_decode(const V& v, const base32_options& opts, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base32_decode(s.data(), s.size(), opts, out, cap);
+}
+
+template <typename V>
+size_t base32_encode(const V& v, const base32_options& opts, std::string& out) {
+    auto s = to_span(v);
+    return base32_encode(s.data(), s.size(), opts, out);
+}
+
+template <typename V>
+size_t base32_decode(const V& v, const base32_options& opts, std::string& out) {
+    auto s = to_span(v);
+    return base32_decode(s.data(), s.size(), opts, out);
+}
+
+template <typename V>
+decode_result try_base32_decode(const V& v, const base32_options& opts, char* out, size_t cap) {
+    auto s = to_span(v);
+    return try_base32_decode(s.data(), s.size(), opts, out, cap);
+}
+
+template <typename V>
+decode_result try_base32_decode(const V& v, const base32_options& opts, std::string& out) {
+    auto s = to_span(v);
+    return try_base32_decode(s.data(), s.size(), opts, out);
+}
+
+template <typename V>
+decode_result base32_validate(const V& v, const base32_options& opts) {
+    auto s = to_span(v);
+    return base32_validate(s.data(), s.size(), opts);
+}
+
+template <typename V>
+size_t base32_encode_size(const V& v, const base32_options& opts) {
+    auto s = to_span(v);
+    return base32_encode_size(s.data(), s.size(), opts);
+}
+
+template <typename V>
+size_t base32_encode_size(const V& v) {
+    auto s = to_span(v);
+    return base32_encode_size(s.data(), s.size());
+}
+
+template <typename V>
+size_t base32_decode_size(const V& v) {
+    auto s = to_span(v);
+    return base32_decode_size(s.data(), s.size());
+}
+
+}  // namespace ss
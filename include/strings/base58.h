@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <strings/object.h>
+
+namespace ss {
+
+// Bitcoin's alphabet, without 0, O, I and l. Each leading zero byte is a
+// leading '1'. The number is converted through limbs of 5 digits (58^5) on
+// one side and 32 bits on the other, about 20 times fewer multiply-adds than
+// dividing out one digit at a time.
+std::string base58_encode(const char* buf, size_t len);
+std::string base58_decode(const char* buf, size_t len);
+
+// Write into `out` (at least base58_xxx_size() bytes), return the bytes written.
+size_t base58_encode(const char* buf, size_t len, char* out, size_t cap);
+size_t base58_decode(const char* buf, size_t len, char* out, size_t cap);
+
+// Append to `out`, return the bytes appended.
+size_t base58_encode(const char* buf, size_t len, std::string& out);
+size_t base58_decode(const char* buf, size_t len, std::string& out);
+
+// Decode without throwing: a bad byte is reported in the result and leaves an
+// appended `out` as it was.
+decode_result try_base58_decode(const char* buf, size_t len, char* out, size_t cap);
+decode_result try_base58_decode(const char* buf, size_t len, std::string& out);
+
+// Upper bounds, the exact sizes depend on the value.
+inline size_t base58_encode_size(const char* buf, size_t len) {
+    return len * 138 / 100 + 1;  // log(256) / log(58) < 1.38
+}
+
+inline size_t base58_decode_size(const char* buf, size_t len) {
+    size_t ones = 0;
+    for (; ones < len && buf[ones] == '1'; ++ones)
+        ;
+    return ones + (len - ones) * 733 / 1000 + 1;  // log(58) / log(256) < 0.733
+}
+
+template <typename V>
+std::string base58_encode(const V& v) {
+    auto s = to_span(v);
+    return base58_encode(s.data(), s.size());
+}
+
+template <typename V>
+std::string base58_decode(const V& v) {
+    auto s = to_span(v);
+    return base58_decode(s.data(), s.size());
+}
+
+template <typename V>
+size_t base58_encode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base58_encode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t base58_decode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base58_decode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t base58_encode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return base58_encode(s.data(), s.size(), out);
+}
+
+template <typename V>
+size_t base58_decode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return base58_decode(s.data(), s.size(), out);
+}
+
+template <typename V>
+decode_result try_base58_decode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return try_base58_decode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+decode_result try_base58_decode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return try_base58_decode(s.data(), s.size(), out);
+}
+
+template <typename V>
+size_t base58_encode_size(const V& v) {
+    auto s = to_span(v);
+    return base58_encode_size(s.data(), s.size());
+}
+
+template <typename V>
+size_t base58_decode_size(const V& v) {
+    auto s = to_span(v);
+    return base58_decode_size(s.data(), s.size());
+}
+
+}  // namespace ss
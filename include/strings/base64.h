@@ -1,22 +1,131 @@
 #pragma once
 
+#include <stdexcept>
+#include <stdint.h>
 #include <string>
+#include <string_view>
 #include <strings/object.h>
 
 namespace ss {
 
+// 64 distinct ASCII characters other than '=', in value order; throws
+// std::runtime_error otherwise. The standard and URL-safe alphabets run
+// dedicated kernels, any other one a table-driven kernel.
+class base64_alphabet {
+public:
+    enum kind_t : uint8_t { custom, standard, url };
+
+    constexpr explicit base64_alphabet(std::string_view chars) {
+        if (chars.size() != 64) {
+            throw std::runtime_error("Invalid base64 alphabet");
+        }
+        for (auto& v : values_) {
+            v = 0xFF;
+        }
+        for (size_t i = 0; i < 64; ++i) {
+            const uint8_t c = (uint8_t)chars[i];
+            if (c >= 0x80 || c == '=' || values_[c] != 0xFF) {
+                throw std::runtime_error("Invalid base64 alphabet");
+            }
+            chars_[i]  = chars[i];
+            values_[c] = (uint8_t)i;
+        }
+        const std::string_view head = chars.substr(0, 62), tail = chars.substr(62);
+        if (head == "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789") {
+            kind_ = tail == "+/" ? standard : tail == "-_" ? url : custom;
+        }
+    }
+
+    constexpr const char* chars() const { return chars_; }
+    // Indexed by character, 0xFF for those outside the alphabet.
+    constexpr const uint8_t* values() const { return values_; }
+    constexpr kind_t kind() const { return kind_; }
+
+private:
+    char chars_[64]      = {};
+    uint8_t values_[128] = {};
+    kind_t kind_         = custom;
+};
+
+inline constexpr base64_alphabet base64_std{
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+inline constexpr base64_alphabet base64_url{
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"};
+
+enum class base64_padding : uint8_t {
+    required,   // encode pads to a multiple of 4 chars, decode insists on it
+    optional,   // encode pads, decode accepts padded and unpadded text
+    forbidden,  // encode omits '=', decode rejects it
+};
+
+struct base64_options {
+    const base64_alphabet* alphabet = &base64_std;
+    base64_padding padding          = base64_padding::required;
+    // Encode: lines of `wrap` chars, a multiple of 4 or 0 for a single line,
+    // joined by `newline`. There is no break after the last line.
+    size_t wrap              = 0;
+    std::string_view newline = "\r\n";
+    // Decode: ignore ASCII whitespace anywhere in the text.
+    bool skip_space = false;
+};
+
+// RFC 2045 bodies and RFC 7468 (PEM) payloads.
+inline constexpr base64_options base64_mime{&base64_std, base64_padding::required, 76, "\r\n",
+                                            true};
+inline constexpr base64_options base64_pem{&base64_std, base64_padding::required, 64, "\n",
+                                           true};
+
 std::string base64_encode(const char* buf, size_t len);
 std::string base64_decode(const char* buf, size_t len);
 
+// Write into `out` (at least base64_xxx_size() bytes), return the bytes written.
+size_t base64_encode(const char* buf, size_t len, char* out, size_t cap);
+size_t base64_decode(const char* buf, size_t len, char* out, size_t cap);
+
+// Append to `out`, return the bytes appended.
+size_t base64_encode(const char* buf, size_t len, std::string& out);
+size_t base64_decode(const char* buf, size_t len, std::string& out);
+
+// Decode without throwing: bad input is reported in the result and leaves an
+// appended `out` as it was.
+decode_result try_base64_decode(const char* buf, size_t len, char* out, size_t cap);
+decode_result try_base64_decode(const char* buf, size_t len, std::string& out);
+// Check `buf` the way base64_decode() would, writing nothing.
+decode_result base64_validate(const char* buf, size_t len);
+
+// Other alphabets, padding policies and line handling, e.g.
+// {&base64_url, base64_padding::forbidden} for JWTs or base64_pem.
+std::string base64_encode(const char* buf, size_t len, const base64_options& opts);
+std::string base64_decode(const char* buf, size_t len, const base64_options& opts);
+size_t base64_encode(const char* buf, size_t len, const base64_options& opts, char* out,
+                     size_t cap);
+size_t base64_decode(const char* buf, size_t len, const base64_options& opts, char* out,
+                     size_t cap);
+size_t base64_encode(const char* buf, size_t len, const base64_options& opts, std::string& out);
+size_t base64_decode(const char* buf, size_t len, const base64_options& opts, std::string& out);
+decode_result try_base64_decode(const char* buf, size_t len, const base64_options& opts,
+                                char* out, size_t cap);
+decode_result try_base64_decode(const char* buf, size_t len, const base64_options& opts,
+                                std::string& out);
+decode_result base64_validate(const char* buf, size_t len, const base64_options& opts);
+
 inline size_t base64_encode_size(const char* buf, size_t len) {
     return ((len + 2) / 3) * 4;
 }
 
+inline size_t base64_encode_size(const char* buf, size_t len, const base64_options& opts) {
+    const size_t n = opts.padding == base64_padding::forbidden ? (len * 4 + 2) / 3
+                                                               : base64_encode_size(buf, len);
+    return opts.wrap == 0 || n == 0 ? n : n + (n - 1) / opts.wrap * opts.newline.size();
+}
+
+// Exact for valid text, padded or not; an upper bound when it holds whitespace.
 inline size_t base64_decode_size(const char* buf, size_t len) {
     size_t padding = 0;
-    for (int i = len - 1; i >= 0 && buf[i] == '='; --i, ++padding)
+    for (int i = len - 1; i >= 0 && buf[i] == '=' && padding < 2; --i, ++padding)
         ;
-    return (len / 4) * 3 - padding;
+    const size_t n = len - padding;
+    return n / 4 * 3 + (n % 4 > 1 ? n % 4 - 1 : 0);
 }
 
 template <typename V>
@@ -31,6 +140,108 @@ std::string base64_decode(const V& v) {
     return base64_decode(s.data(), s.size());
 }
 
+template <typename V>
+size_t base64_encode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base64_encode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t base64_decode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base64_decode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t base64_encode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return base64_encode(s.data(), s.size(), out);
+}
+
+template <typename V>
+size_t base64_decode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return base64_decode(s.data(), s.size(), out);
+}
+
+template <typename V>
+decode_result try_base64_decode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return try_base64_decode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+decode_result try_base64_decode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return try_base64_decode(s.data(), s.size(), out);
+}
+
+template <typename V>
+decode_result base64_validate(const V& v) {
+    auto s = to_span(v);
+    return base64_validate(s.data(), s.size());
+}
+
+template <typename V>
+std::string base64_encode(const V& v, const base64_options& opts) {
+    auto s = to_span(v);
+    return base64_encode(s.data(), s.size(), opts);
+}
+
+template <typename V>
+std::string base64_decode(const V& v, const base64_options& opts) {
+    auto s = to_span(v);
+    return base64_decode(s.data(), s.size(), opts);
+}
+
+template <typename V>
+size_t base64_encode(const V& v, const base64_options& opts, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base64_encode(s.data(), s.size(), opts, out, cap);
+}
+
+template <typename V>
+size_t base64_decode(const V& v, const base64_options& opts, char* out, size_t cap) {
+    auto s = to_span(v);
+    return base64_decode(s.data(), s.size(), opts, out, cap);
+}
+
+template <typename V>
+size_t base64_encode(const V& v, const base64_options& opts, std::string& out) {
+    auto s = to_span(v);
+    return base64_encode(s.data(), s.size(), opts, out);
+}
+
+template <typename V>
+size_t base64_decode(const V& v, const base64_options& opts, std::string& out) {
+    auto s = to_span(v);
+    return base64_decode(s.data(), s.size(), opts, out);
+}
+
+template <typename V>
+decode_result try_base64_decode(const V& v, const base64_options& opts, char* out, size_t cap) {
+    auto s = to_span(v);
+    return try_base64_decode(s.data(), s.size(), opts, out, cap);
+}
+
+template <typename V>
+decode_result try_base64_decode(const V& v, const base64_options& opts, std::string& out) {
+    auto s = to_span(v);
+    return try_base64_decode(s.data(), s.size(), opts, out);
+}
+
+template <typename V>
+decode_result base64_validate(const V& v, const base64_options& opts) {
+    auto s = to_span(v);
+    return base64_validate(s.data(), s.size(), opts);
+}
+
+template <typename V>
+size_t base64_encode_size(const V& v, const base64_options& opts) {
+    auto s = to_span(v);
+    return base64_encode_size(s.data(), s.size(), opts);
+}
+
 template <typename V>
 size_t base64_encode_size(const V& v) {
     auto s = to_span(v);
@@ -43,4 +254,83 @@ size_t base64_decode_size(const V& v) {
     return base64_decode_size(s.data(), s.size());
 }
 
+// Chunked encoder: update() keeps the trailing partial 3-byte group for the next
+// call and final() emits it with padding. The concatenated output is identical
+// to base64_encode() over the whole input with the same options, line breaks
+// included, so a multi-MB PEM body can be written a buffer at a time.
+class base64_encoder {
+    base64_options opts_;
+    char carry_[3];
+    size_t ncarry_ = 0;
+    size_t column_ = 0;  // chars on the current line
+
+    size_t put(const char* buf, size_t len, char* out);
+
+public:
+    base64_encoder() = default;
+    // Throws std::runtime_error for a `wrap` that is not a multiple of 4.
+    explicit base64_encoder(const base64_options& opts);
+
+    // Max bytes written by update(len) / final().
+    size_t update_size(size_t len) const {
+        const size_t n = (ncarry_ + len) / 3 * 4;
+        return opts_.wrap == 0 ? n : n + (column_ + n) / opts_.wrap * opts_.newline.size();
+    }
+    size_t final_size() const {
+        if (ncarry_ == 0) {
+            return 0;
+        }
+        const size_t n = opts_.padding == base64_padding::forbidden ? ncarry_ + 1 : 4;
+        return column_ == opts_.wrap && opts_.wrap > 0 ? n + opts_.newline.size() : n;
+    }
+
+    size_t update(const char* buf, size_t len, char* out, size_t cap);
+    size_t update(const char* buf, size_t len, std::string& out);
+    size_t final(char* out, size_t cap);
+    size_t final(std::string& out);
+
+    template <typename V>
+    size_t update(const V& v, std::string& out) {
+        auto s = to_span(v);
+        return update(s.data(), s.size(), out);
+    }
+};
+
+// Chunked decoder: update() keeps the trailing partial 4-char group for the next
+// call, final() checks that the input ended on a group boundary, or writes the
+// last unpadded group when the padding policy allows one. Padding may only
+// appear in the last group. Offsets in input_error are relative to the stream,
+// whitespace included when it is skipped.
+class base64_decoder {
+    base64_options opts_;
+    char carry_[4];
+    size_t carry_at_[4] = {};  // stream offsets of the carried chars, with skip_space
+    size_t ncarry_ = 0;
+    size_t offset_ = 0;  // chars consumed so far, whitespace excluded
+    size_t raw_    = 0;  // bytes consumed so far
+    bool done_     = false;
+
+    size_t put(const char* buf, size_t len, char* out);
+
+public:
+    base64_decoder() = default;
+    explicit base64_decoder(const base64_options& opts) : opts_(opts) {}
+
+    size_t update_size(size_t len) const { return (ncarry_ + len) / 4 * 3; }
+    size_t final_size() const { return ncarry_ > 1 ? ncarry_ - 1 : 0; }
+
+    size_t update(const char* buf, size_t len, char* out, size_t cap);
+    size_t update(const char* buf, size_t len, std::string& out);
+    size_t final(char* out, size_t cap);
+    size_t final(std::string& out);
+    // For streams that end on a group boundary.
+    void final();
+
+    template <typename V>
+    size_t update(const V& v, std::string& out) {
+        auto s = to_span(v);
+        return update(s.data(), s.size(), out);
+    }
+};
+
 }  // namespace ss
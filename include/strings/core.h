@@ -1,7 +1,15 @@
 #pragma once
 
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 #include <strings/object.h>
 
@@ -10,12 +18,410 @@ namespace ss {
 std::vector<std::string_view>  //
 str_split(std::string_view str, std::string_view delimiter, bool trim = false);
 
-std::string str_join(const std::vector<std::string_view>& vs, std::string_view delimiter);
+// Clears `out` and fills it with the fields, keeping its capacity across calls.
+// Returns the number of fields.
+size_t str_split_into(std::string_view str, std::string_view delimiter,
+                      std::vector<std::string_view>& out, bool trim = false);
+
+// Lazy str_split(): `for (auto field : split_view(s, ","))` yields the same
+// fields without allocating. An empty delimiter yields `str` as one field.
+class split_view {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const std::string_view*;
+        using reference         = const std::string_view&;
+
+        iterator() = default;
+
+        reference operator*() const { return field_; }
+        pointer operator->() const { return &field_; }
+
+        iterator& operator++() {
+            next();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            next();
+            return tmp;
+        }
+
+        bool operator==(const iterator& o) const { return pos_ == o.pos_; }
+        bool operator!=(const iterator& o) const { return pos_ != o.pos_; }
+
+    private:
+        friend class split_view;
+
+        explicit iterator(const split_view* view) : view_(view), next_(0) { next(); }
+
+        void next();
+
+        const split_view* view_ = nullptr;
+        size_t pos_             = std::string_view::npos;  // npos at the end
+        size_t next_            = std::string_view::npos;  // start of the next field
+        std::string_view field_;
+    };
+
+    split_view(std::string_view str, std::string_view delimiter, bool trim = false)
+      : str_(str), delimiter_(delimiter), trim_(trim) {}
+
+    iterator begin() const { return iterator(this); }
+    iterator end() const { return iterator(); }
+
+private:
+    std::string_view str_;
+    std::string_view delimiter_;
+    bool trim_;
+};
+
+// A byte set for the str_*_of() family, compiled once into a 32-byte nibble
+// table. Build it once (e.g. a `static const charset`) for sets used in loops.
+class charset {
+public:
+    charset(std::string_view chars);
+    charset(const char* chars) : charset(std::string_view(chars)) {}
+
+    bool contains(char ch) const {
+        const auto c = (unsigned char)ch;
+        return table_[(c & 0x0f) | (c >> 7 << 4)] >> (c >> 4 & 7) & 1;
+    }
+
+    const uint8_t* table() const { return table_; }
+
+private:
+    alignas(16) uint8_t table_[32] = {};
+};
+
+// Position of the first byte at or after `pos` that is (not) in `set`, or npos.
+size_t str_find_first_of(std::string_view s, const charset& set, size_t pos = 0);
+size_t str_find_first_not_of(std::string_view s, const charset& set, size_t pos = 0);
+
+// Length of the prefix of `s` made only of bytes in `set`, like strspn().
+size_t str_span(std::string_view s, const charset& set);
+
+// Split at every byte in `delimiters`; adjacent delimiters yield empty fields.
+// With `trim` the fields are trimmed in the same pass.
+std::vector<std::string_view>  //
+str_split_any(std::string_view str, const charset& delimiters, bool trim = false);
+
+size_t str_split_any_into(std::string_view str, const charset& delimiters,
+                          std::vector<std::string_view>& out, bool trim = false);
+
+namespace detail {
+
+struct join_identity {
+    template <typename T>
+    std::string_view operator()(const T& v) const {
+        return to_span(v);
+    }
+};
+
+inline char* copy_bytes(char* p, std::string_view s) {
+    if (!s.empty()) {
+        memcpy(p, s.data(), s.size());
+    }
+    return p + s.size();
+}
+
+template <typename R, typename Proj>
+size_t join_size(const R& range, std::string_view delimiter, Proj& proj) {
+    size_t total = 0;
+    size_t count = 0;
+    for (const auto& v : range) {
+        const auto& r = proj(v);
+        total += to_span(r).size();
+        ++count;
+    }
+    return count == 0 ? 0 : total + delimiter.size() * (count - 1);
+}
+
+template <typename R, typename Proj>
+char* join_write(const R& range, std::string_view delimiter, Proj& proj, char* p) {
+    bool first = true;
+    for (const auto& v : range) {
+        if (!first) {
+            p = copy_bytes(p, delimiter);
+        }
+        first         = false;
+        const auto& r = proj(v);
+        p             = copy_bytes(p, to_span(r));
+    }
+    return p;
+}
+
+template <typename R, typename Proj>
+using if_projection_t =
+    std::enable_if_t<std::is_invocable_v<Proj&, decltype(*std::begin(std::declval<const R&>()))>>;
+
+}  // namespace detail
+
+// Join any range of string-like values (std::string, string_view, C strings,
+// char vectors) in one allocation, sized in size_t.
+template <typename R>
+size_t str_join_size(const R& range, std::string_view delimiter) {
+    detail::join_identity proj;
+    return detail::join_size(range, delimiter, proj);
+}
+
+// Append to `out`, return the bytes appended. `proj` maps an element to
+// something string-like; it is called twice per element (size, then copy).
+template <typename R, typename Proj, typename = detail::if_projection_t<R, Proj>>
+size_t str_join(const R& range, std::string_view delimiter, Proj proj, std::string& out) {
+    const size_t n   = detail::join_size(range, delimiter, proj);
+    const size_t old = out.size();
+    out.resize(old + n);
+    try {
+        detail::join_write(range, delimiter, proj, out.data() + old);
+    } catch (...) {
+        out.resize(old);
+        throw;
+    }
+    return n;
+}
+
+template <typename R>
+size_t str_join(const R& range, std::string_view delimiter, std::string& out) {
+    return str_join(range, delimiter, detail::join_identity{}, out);
+}
+
+// Write into `out` (at least str_join_size() bytes), return the bytes written.
+template <typename R>
+size_t str_join(const R& range, std::string_view delimiter, char* out, size_t cap) {
+    detail::join_identity proj;
+    const size_t n = detail::join_size(range, delimiter, proj);
+    if (cap < n) {
+        throw std::length_error("Output buffer too small");
+    }
+    detail::join_write(range, delimiter, proj, out);
+    return n;
+}
+
+template <typename R, typename Proj, typename = detail::if_projection_t<R, Proj>>
+std::string str_join(const R& range, std::string_view delimiter, Proj proj) {
+    std::string out;
+    str_join(range, delimiter, proj, out);
+    return out;
+}
+
+template <typename R>
+std::string str_join(const R& range, std::string_view delimiter) {
+    return str_join(range, delimiter, detail::join_identity{});
+}
+
+inline std::string str_join(std::initializer_list<std::string_view> vs,
+                            std::string_view delimiter) {
+    return str_join<std::initializer_list<std::string_view>>(vs, delimiter);
+}
+
+namespace detail {
+
+template <typename T, std::enable_if_t<std::is_same_v<T, char>, int> = 0>
+constexpr size_t concat_size(T) {
+    return 1;
+}
+
+constexpr size_t concat_size(std::string_view s) {
+    return s.size();
+}
+
+template <typename T, std::enable_if_t<std::is_same_v<T, char>, int> = 0>
+char* concat_write(char* p, T c) {
+    *p = c;
+    return p + 1;
+}
+
+inline char* concat_write(char* p, std::string_view s) {
+    return copy_bytes(p, s);
+}
+
+}  // namespace detail
+
+// Append strings and single chars to `out` with one resize, return the bytes
+// appended. Sizes of literals fold to constants. Arguments must not alias `out`.
+template <typename... Ts>
+size_t str_append(std::string& out, const Ts&... xs) {
+    const size_t n   = (detail::concat_size(xs) + ... + 0);
+    const size_t old = out.size();
+    out.resize(old + n);
+    char* p = out.data() + old;
+    ((p = detail::concat_write(p, xs)), ...);
+    (void)p;
+    return n;
+}
+
+// str_concat("key=", k, ';') replaces `a + b + c` chains with one allocation.
+template <typename... Ts>
+std::string str_concat(const Ts&... xs) {
+    std::string out;
+    str_append(out, xs...);
+    return out;
+}
 
 std::string str_toupper(std::string_view s);
 std::string str_tolower(std::string_view s);
 
+// ASCII only, other bytes are copied unchanged. Write `len` bytes into `out`
+// (may be `s`), return the bytes written.
+size_t str_toupper(const char* s, size_t len, char* out, size_t cap);
+size_t str_tolower(const char* s, size_t len, char* out, size_t cap);
+
+void str_toupper_inplace(std::string& s);
+void str_tolower_inplace(std::string& s);
+
+// ASCII case-insensitive matching, folded in the compare loop without copies.
+bool str_iequals(std::string_view a, std::string_view b);
+bool str_istarts_with(std::string_view s, std::string_view prefix);
+bool str_iends_with(std::string_view s, std::string_view suffix);
+// Position of the first match at or after `pos`, or npos.
+size_t str_find(std::string_view s, std::string_view needle, size_t pos = 0);
+size_t str_ifind(std::string_view s, std::string_view needle, size_t pos = 0);
+
+// A needle compiled once for repeated searches. Needles shorter than
+// kRaitaMin use the SIMD first/last-byte filter, longer ones Raita.
+class searcher {
+public:
+    static constexpr size_t kRaitaMin = 64;
+
+    explicit searcher(std::string_view needle);
+
+    // First occurrence at or after `pos`, or npos.
+    size_t find(std::string_view hay, size_t pos = 0) const;
+    // Last occurrence starting at or before `pos`, or npos.
+    size_t rfind(std::string_view hay, size_t pos = std::string_view::npos) const;
+    // Non-overlapping occurrences, as a left-to-right find() loop sees them.
+    size_t count(std::string_view hay) const;
+    // Clears `out` and fills it with the count() positions, keeping its capacity.
+    size_t find_all(std::string_view hay, std::vector<size_t>& out) const;
+
+    std::string_view needle() const { return needle_; }
+
+private:
+    const uint32_t* skip() const { return skip_.empty() ? nullptr : skip_.data(); }
+
+    std::string needle_;
+    std::vector<uint32_t> skip_;  // Horspool shifts, long needles only
+};
+
+// Byte-wise rewrites; the _inplace forms work on `s` directly.
+std::string str_replace_byte(std::string_view s, char from, char to);
+void str_replace_byte_inplace(std::string& s, char from, char to);
+// Replace every byte b with table[b].
+std::string str_translate(std::string_view s, const uint8_t table[256]);
+void str_translate_inplace(std::string& s, const uint8_t table[256]);
+
+// Drop the bytes in `set`. Write into `out` (at least `len` bytes, may be `s`),
+// return the bytes written.
+std::string str_remove_bytes(std::string_view s, const charset& set);
+size_t str_remove_bytes(const char* s, size_t len, const charset& set, char* out, size_t cap);
+
+// Replace the non-overlapping occurrences of `needle` left to right. The output
+// is sized by a counting pass and allocated once. An empty needle matches nothing.
+std::string str_replace_all(std::string_view s, std::string_view needle, std::string_view repl);
+std::string str_replace_all(std::string_view s, const searcher& needle, std::string_view repl);
+// Append to `out`, return the bytes appended.
+size_t str_replace_all(std::string_view s, std::string_view needle, std::string_view repl,
+                       std::string& out);
+size_t str_replace_all(std::string_view s, const searcher& needle, std::string_view repl,
+                       std::string& out);
+
+namespace detail {
+
+// Callback of multi_searcher::find_all(), false stops the scan.
+using match_fn = bool (*)(void* ctx, size_t pattern_id, size_t offset);
+
+// What the Teddy kernel needs from a multi_searcher.
+struct teddy_plan {
+    const uint8_t* masks;          // k x {lo[16], hi[16]} nibble -> bucket bits
+    size_t k;                      // leading bytes filtered, 1..3
+    const char* bytes;             // all patterns back to back
+    const uint32_t* offsets;       // pattern i is bytes[offsets[i], offsets[i + 1])
+    const uint32_t* ids;           // pattern ids grouped by bucket
+    const uint32_t* bucket_begin;  // bucket b is ids[bucket_begin[b], bucket_begin[b + 1])
+};
+
+}  // namespace detail
+
+// Literal multi-pattern matcher built once from a pattern list. Up to
+// kTeddyMax patterns are found with Teddy: the first bytes of every window
+// are classified into 8 pattern buckets by nibble TableLookupBytes, and only
+// windows with a bucket hit are verified. Larger sets use an Aho-Corasick
+// DFA over the byte classes that occur in the patterns.
+class multi_searcher {
+public:
+    static constexpr size_t kTeddyMax = 64;
+
+    // Throws std::runtime_error on an empty pattern.
+    explicit multi_searcher(const std::vector<std::string_view>& patterns);
+    multi_searcher(std::initializer_list<std::string_view> patterns)
+      : multi_searcher(std::vector<std::string_view>(patterns)) {}
+
+    size_t size() const { return offsets_.size() - 1; }
+
+    std::string_view pattern(size_t id) const {
+        return std::string_view(bytes_).substr(offsets_[id], offsets_[id + 1] - offsets_[id]);
+    }
+
+    // Calls on_match(pattern_id, offset) for every occurrence of every pattern,
+    // overlaps included, in no particular order. If on_match returns bool,
+    // false stops the scan. Returns false if stopped.
+    template <typename F>
+    bool find_all(std::string_view hay, F&& on_match) const {
+        using Fn = std::remove_reference_t<F>;
+        auto fn  = [](void* ctx, size_t id, size_t pos) -> bool {
+            if constexpr (std::is_void_v<std::invoke_result_t<Fn&, size_t, size_t>>) {
+                (*(Fn*)ctx)(id, pos);
+                return true;
+            } else {
+                return (*(Fn*)ctx)(id, pos);
+            }
+        };
+        return scan(hay, fn, (void*)std::addressof(on_match));
+    }
+
+    bool contains_any(std::string_view hay) const {
+        return !find_all(hay, [](size_t, size_t) { return false; });
+    }
+
+private:
+    bool scan(std::string_view hay, detail::match_fn fn, void* ctx) const;
+
+    std::string bytes_;
+    std::vector<uint32_t> offsets_;
+    // Teddy
+    alignas(16) uint8_t masks_[3 * 32] = {};
+    size_t k_ = 0;
+    std::vector<uint32_t> ids_;
+    uint32_t bucket_begin_[9] = {};
+    // Aho-Corasick
+    uint8_t classes_[256] = {};
+    size_t nclasses_      = 0;
+    std::vector<uint32_t> delta_;  // state * nclasses_ + class -> state
+    std::vector<int32_t> term_;    // state -> a pattern ending there, or -1
+    std::vector<uint32_t> dict_;   // state -> nearest terminal proper suffix, 0 if none
+    std::vector<int32_t> dup_;     // pattern -> next identical pattern, or -1
+};
+
+// Equal for strings that are str_iequals(). Not stable across byte orders.
+uint64_t str_ihash(std::string_view s);
+
+// For case-insensitive unordered containers.
+struct str_ihasher {
+    size_t operator()(std::string_view s) const { return (size_t)str_ihash(s); }
+};
+
+struct str_iequal_to {
+    bool operator()(std::string_view a, std::string_view b) const { return str_iequals(a, b); }
+};
+
+// Strip ASCII whitespace (" \t\n\v\f\r"), independent of the locale.
 std::string_view str_trim(std::string_view str);
+std::string_view str_ltrim(std::string_view str);
+std::string_view str_rtrim(std::string_view str);
 
 bool str_starts_with(std::string_view s, std::string_view perfix);
 bool str_ends_with(std::string_view s, std::string_view perfix);
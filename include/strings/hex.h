@@ -5,9 +5,46 @@
 
 namespace ss {
 
+struct hex_options {
+    bool upper     = false;  // "ABCDEF" instead of "abcdef"
+    char separator = 0;      // between bytes, e.g. ':' or ' '; 0 for none
+    bool prefix    = false;  // "0x" once in front
+};
+
 std::string hex_encode(const char* buf, size_t len);
 std::string hex_decode(const char* buf, size_t len);
 
+// Write into `out` (at least hex_xxx_size() bytes), return the bytes written.
+size_t hex_encode(const char* buf, size_t len, char* out, size_t cap);
+size_t hex_decode(const char* buf, size_t len, char* out, size_t cap);
+
+// Append to `out`, return the bytes appended.
+size_t hex_encode(const char* buf, size_t len, std::string& out);
+size_t hex_decode(const char* buf, size_t len, std::string& out);
+
+// Decode without throwing: bad input is reported in the result and leaves an
+// appended `out` as it was.
+decode_result try_hex_decode(const char* buf, size_t len, char* out, size_t cap);
+decode_result try_hex_decode(const char* buf, size_t len, std::string& out);
+// Check `buf` the way hex_decode() would, writing nothing.
+decode_result hex_validate(const char* buf, size_t len);
+
+std::string hex_encode(const char* buf, size_t len, const hex_options& opts);
+size_t hex_encode(const char* buf, size_t len, const hex_options& opts, char* out, size_t cap);
+size_t hex_encode(const char* buf, size_t len, const hex_options& opts, std::string& out);
+
+inline size_t hex_encode_size(const char* buf, size_t len) {
+    return len * 2;
+}
+
+inline size_t hex_encode_size(const char* buf, size_t len, const hex_options& opts) {
+    return (opts.prefix ? 2 : 0) + len * 2 + (opts.separator && len ? len - 1 : 0);
+}
+
+inline size_t hex_decode_size(const char* buf, size_t len) {
+    return len / 2;
+}
+
 template <typename V>
 std::string hex_encode(const V& v) {
     auto s = to_span(v);
@@ -20,4 +57,82 @@ std::string hex_decode(const V& v) {
     return hex_decode(s.data(), s.size());
 }
 
+template <typename V>
+size_t hex_encode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return hex_encode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t hex_decode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return hex_decode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t hex_encode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return hex_encode(s.data(), s.size(), out);
+}
+
+template <typename V>
+size_t hex_decode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return hex_decode(s.data(), s.size(), out);
+}
+
+template <typename V>
+std::string hex_encode(const V& v, const hex_options& opts) {
+    auto s = to_span(v);
+    return hex_encode(s.data(), s.size(), opts);
+}
+
+template <typename V>
+size_t hex_encode(const V& v, const hex_options& opts, char* out, size_t cap) {
+    auto s = to_span(v);
+    return hex_encode(s.data(), s.size(), opts, out, cap);
+}
+
+template <typename V>
+size_t hex_encode(const V& v, const hex_options& opts, std::string& out) {
+    auto s = to_span(v);
+    return hex_encode(s.data(), s.size(), opts, out);
+}
+
+template <typename V>
+decode_result try_hex_decode(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return try_hex_decode(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+decode_result try_hex_decode(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return try_hex_decode(s.data(), s.size(), out);
+}
+
+template <typename V>
+decode_result hex_validate(const V& v) {
+    auto s = to_span(v);
+    return hex_validate(s.data(), s.size());
+}
+
+template <typename V>
+size_t hex_encode_size(const V& v) {
+    auto s = to_span(v);
+    return hex_encode_size(s.data(), s.size());
+}
+
+template <typename V>
+size_t hex_encode_size(const V& v, const hex_options& opts) {
+    auto s = to_span(v);
+    return hex_encode_size(s.data(), s.size(), opts);
+}
+
+template <typename V>
+size_t hex_decode_size(const V& v) {
+    auto s = to_span(v);
+    return hex_decode_size(s.data(), s.size());
+}
+
 }  // namespace ss
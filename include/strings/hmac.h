@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <strings/md5.h>
+#include <strings/object.h>
+#include <strings/sha1.h>
+
+namespace ss {
+
+// HMAC key state: the ipad/opad blocks are absorbed once at construction, so
+// each sign() costs only the message blocks plus two finalizations. sign() is
+// const and works on copies of the contexts, so a key can be shared across threads.
+class hmac_sha1_key {
+    SHA1_CTX inner_;
+    SHA1_CTX outer_;
+
+public:
+    hmac_sha1_key(const char* key, size_t len);
+
+    template <typename V>
+    explicit hmac_sha1_key(const V& key) : hmac_sha1_key(to_span(key).data(), to_span(key).size()) {}
+
+    // Write the mac (sha1_digest_size bytes) into `out`, return the bytes written.
+    size_t sign(const char* msg, size_t len, char* out, size_t cap) const;
+};
+
+class hmac_md5_key {
+    md5_ctx inner_;
+    md5_ctx outer_;
+
+public:
+    hmac_md5_key(const char* key, size_t len);
+
+    template <typename V>
+    explicit hmac_md5_key(const V& key) : hmac_md5_key(to_span(key).data(), to_span(key).size()) {}
+
+    // Write the mac (md5_digest_size bytes) into `out`, return the bytes written.
+    size_t sign(const char* msg, size_t len, char* out, size_t cap) const;
+};
+
+std::vector<char> hmac_sha1(const hmac_sha1_key& key, const char* msg, size_t len);
+std::vector<char> hmac_sha1(const char* key, size_t key_len, const char* msg, size_t len);
+
+std::vector<char> hmac_md5(const hmac_md5_key& key, const char* msg, size_t len);
+std::vector<char> hmac_md5(const char* key, size_t key_len, const char* msg, size_t len);
+
+template <typename V>
+std::vector<char> hmac_sha1(const hmac_sha1_key& key, const V& msg) {
+    auto m = to_span(msg);
+    return hmac_sha1(key, m.data(), m.size());
+}
+
+template <typename Tk, typename Tm>
+std::vector<char> hmac_sha1(const Tk& key, const Tm& msg) {
+    auto k = to_span(key);
+    auto m = to_span(msg);
+    return hmac_sha1(k.data(), k.size(), m.data(), m.size());
+}
+
+template <typename V>
+std::vector<char> hmac_md5(const hmac_md5_key& key, const V& msg) {
+    auto m = to_span(msg);
+    return hmac_md5(key, m.data(), m.size());
+}
+
+template <typename Tk, typename Tm>
+std::vector<char> hmac_md5(const Tk& key, const Tm& msg) {
+    auto k = to_span(key);
+    auto m = to_span(msg);
+    return hmac_md5(k.data(), k.size(), m.data(), m.size());
+}
+
+}  // namespace ss
@@ -2,16 +2,48 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <strings/object.h>
 #include <strings/hex.h>
+#include <memory>
+#include <stdint.h>
 
 namespace ss {
 
+// Plain value type, copy it to fork a hash mid-stream.
+struct md5_ctx {
+    uint32_t state[4];
+    uint64_t count;  // bytes
+    alignas(64) unsigned char buffer[64];
+};
+
+inline constexpr size_t md5_digest_size = 16;
+
+std::unique_ptr<md5_ctx> md5_init();
+void md5_init(md5_ctx* ctx);
+void md5_update(md5_ctx* ctx, const char* buf, size_t len);
+std::vector<char> md5_final(md5_ctx* ctx);
+size_t md5_final(md5_ctx* ctx, char* out, size_t cap);
+
 std::vector<char> md5(const char* buf, size_t len);
 
+// Write the digest into `out` (at least md5_digest_size bytes), return the bytes written.
+size_t md5(const char* buf, size_t len, char* out, size_t cap);
+
+// Append the digest to `out`, return the bytes appended.
+size_t md5(const char* buf, size_t len, std::string& out);
+
+// Hash `count` independent messages at once, one per SIMD u32 lane. Writes
+// count * md5_digest_size bytes to `out`, digests in input order.
+void md5_many(const std::string_view* msgs, size_t count, char* out);
+// Append the digests to `out`, return the bytes appended.
+size_t md5_many(const std::vector<std::string_view>& msgs, std::string& out);
+
 inline
 std::string md5sum(const char* buf, size_t len) {
-    return hex_encode(md5(buf, len));
+    char digest[md5_digest_size];
+    md5(buf, len, digest, md5_digest_size);
+    return hex_encode(digest, md5_digest_size);
 }
 
 template <typename V>
@@ -20,6 +52,18 @@ std::vector<char> md5(const V& v) {
     return md5(s.data(), s.size());
 }
 
+template <typename V>
+size_t md5(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return md5(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t md5(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return md5(s.data(), s.size(), out);
+}
+
 template <typename V>
 std::string md5sum(const V& v) {
     auto s = to_span(v);
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <strings/object.h>
+
+namespace ss {
+
+namespace detail {
+
+// Magnitude and sign of "[+-]digits". On failure `err` is the offset of the
+// first bad byte, or s.size() when the input ends early.
+std::errc parse_magnitude(std::string_view s, uint64_t& mag, bool& neg, size_t& err);
+
+template <typename T>
+std::errc parse_int(std::string_view s, T& value, size_t& err) {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Expect an integer type");
+    uint64_t mag;
+    bool neg;
+    const auto ec = parse_magnitude(s, mag, neg, err);
+    if (ec != std::errc()) {
+        return ec;
+    }
+    if constexpr (std::is_unsigned_v<T>) {
+        if (neg && mag != 0) {
+            err = 0;
+            return std::errc::invalid_argument;
+        }
+        if (mag > std::numeric_limits<T>::max()) {
+            return std::errc::result_out_of_range;
+        }
+        value = (T)mag;
+    } else {
+        using U = std::make_unsigned_t<T>;
+        if (mag > (uint64_t)std::numeric_limits<T>::max() + neg) {
+            return std::errc::result_out_of_range;
+        }
+        value = (T)(neg ? (U)(0 - mag) : (U)mag);
+    }
+    return std::errc();
+}
+
+std::errc parse_float(std::string_view s, double& value, size_t& err);
+
+}  // namespace detail
+
+// Base-10 integer with an optional sign and no surrounding whitespace. Leaves
+// `value` untouched and returns false on a bad byte, empty input or overflow.
+template <typename T>
+bool try_parse_int(std::string_view s, T& value) {
+    size_t err;
+    return detail::parse_int(s, value, err) == std::errc();
+}
+
+// Throws ss::input_error at the first bad byte, std::out_of_range on overflow.
+template <typename T>
+T parse_int(std::string_view s) {
+    T value{};
+    size_t err = 0;
+    const auto ec = detail::parse_int(s, value, err);
+    if (ec == std::errc::invalid_argument) {
+        throw input_error(err, err < s.size() ? s[err] : 0);
+    }
+    if (ec == std::errc::result_out_of_range) {
+        throw std::out_of_range("Integer out of range");
+    }
+    return value;
+}
+
+// "[+-]digits[.digits][(e|E)[+-]digits]", "inf", "infinity" or "nan" in any
+// case, correctly rounded: Clinger's fast path, then Eisel-Lemire, and strtod
+// only for the rare inputs neither can decide.
+bool try_parse_float(std::string_view s, double& value);
+// Throws ss::input_error at the first bad byte, std::out_of_range when a
+// finite input overflows.
+double parse_float(std::string_view s);
+
+inline constexpr size_t format_int_max_size   = 20;  // "-9223372036854775808"
+inline constexpr size_t format_float_max_size = 24;  // "-2.2250738585072014e-308"
+
+// Write into `out`, return the bytes written. No terminating NUL.
+size_t format_int(int64_t v, char* out, size_t cap);
+size_t format_int(uint64_t v, char* out, size_t cap);
+// Shortest text that parses back to `v`, as std::to_chars. Toolchains without
+// floating-point to_chars fall back to snprintf round trips: the fewest
+// significant digits, but the notation is not guaranteed to be the shortest.
+size_t format_float(double v, char* out, size_t cap);
+
+template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+size_t format_int(T v, char* out, size_t cap) {
+    if constexpr (std::is_signed_v<T>) {
+        return format_int((int64_t)v, out, cap);
+    } else {
+        return format_int((uint64_t)v, out, cap);
+    }
+}
+
+struct column_error {
+    size_t field;   // index of the field
+    size_t offset;  // of the bad byte in the column (or within the field for the vector form)
+    std::errc ec;   // invalid_argument or result_out_of_range
+};
+
+// Parse a `delimiter` separated column of int64 in one pass: delimiters are
+// found a vector at a time and fields of up to 16 digits are converted with
+// SIMD multiply-adds. Clears and fills `out` and `errors`; a failed field
+// leaves 0 in `out`. An empty column has no fields. Returns out.size().
+size_t parse_int_column(std::string_view column, char delimiter, std::vector<int64_t>& out,
+                        std::vector<column_error>& errors);
+
+// Same over fields that are already split, e.g. collected from split_view.
+size_t parse_int_column(const std::vector<std::string_view>& fields, std::vector<int64_t>& out,
+                        std::vector<column_error>& errors);
+
+}  // namespace ss
@@ -30,6 +30,10 @@ STRINGS_HAS_MEMBER(size);
 
 namespace ss {
 
+// Name of the SIMD target (e.g. "AVX2", "AVX3_ZEN4") that the kernels are
+// dispatched to on this CPU. Resolved at first call.
+const char* active_target();
+
 // to span
 template <typename V, typename Dummy = std::enable_if_t<strings_has_member_data_v<V>
                                                         || strings_has_member_size_v<V>>>
@@ -58,12 +62,30 @@ public:
     size_t offset() const { return offset_; }
 
     const char* what() const noexcept override {
-        char buf[1024] = {0};
-        auto n = snprintf(buf, 1024, "Input error. offset = %d, byte = %d(%c)", (int)offset_,
+        char buf[80] = {0};
+        auto n = snprintf(buf, sizeof(buf), "Input error. offset = %zu, byte = %d(%c)", offset_,
                           (int)byte_, (char)byte_);
         msg_   = std::string(buf, n);
         return msg_.c_str();
     }
 };
 
+enum class decode_error : uint8_t {
+    none,
+    invalid_byte,      // a byte outside the alphabet
+    invalid_length,    // the input is not a whole number of groups
+    invalid_padding,   // '=' too many or before the end
+    output_too_small,  // the caller buffer cannot hold the result
+};
+
+// Outcome of the try_xxx_decode and xxx_validate functions, which report bad
+// input here instead of throwing.
+struct decode_result {
+    size_t size        = 0;  // decoded bytes; written to the output unless validating
+    size_t offset      = 0;  // of the offending byte, or the input size for invalid_length
+    decode_error error = decode_error::none;
+
+    explicit operator bool() const { return error == decode_error::none; }
+};
+
 }  // namespace ss
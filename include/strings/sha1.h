@@ -2,24 +2,55 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <strings/object.h>
 #include <strings/hex.h>
 #include <memory>
+#include <stdint.h>
 
-struct SHA1_CTX;
+// Plain value type, copy it to fork a hash mid-stream.
+struct SHA1_CTX {
+    uint32_t state[5];
+    uint32_t count[2];
+    uint8_t buffer[64];
+};
 
 namespace ss {
 
+inline constexpr size_t sha1_digest_size = 20;
+
+// Block function in use: "sha-ni" (x86), "armv8" (aarch64) or "scalar". The
+// fastest one supported by the CPU is picked at first use.
+const char* sha1_backend();
+// Force a backend (e.g. for benchmarks); false if unknown or unsupported here.
+bool sha1_set_backend(const char* name);
+
 std::unique_ptr<SHA1_CTX> sha1_init();
+void sha1_init(SHA1_CTX *ctx);
 void sha1_update(SHA1_CTX *ctx, const char* buf, size_t len);
 std::vector<char> sha1_final(SHA1_CTX *ctx);
+size_t sha1_final(SHA1_CTX *ctx, char* out, size_t cap);
 
 std::vector<char>
 sha1(const char* buf, size_t len);
 
+// Write the digest into `out` (at least sha1_digest_size bytes), return the bytes written.
+size_t sha1(const char* buf, size_t len, char* out, size_t cap);
+
+// Append the digest to `out`, return the bytes appended.
+size_t sha1(const char* buf, size_t len, std::string& out);
+
+// Hash `count` independent messages at once, one per SIMD u32 lane. Writes
+// count * sha1_digest_size bytes to `out`, digests in input order.
+void sha1_many(const std::string_view* msgs, size_t count, char* out);
+// Append the digests to `out`, return the bytes appended.
+size_t sha1_many(const std::vector<std::string_view>& msgs, std::string& out);
+
 inline std::string
 sha1sum(const char *buf, size_t len) {
-    return hex_encode(sha1(buf, len));
+    char digest[sha1_digest_size];
+    sha1(buf, len, digest, sha1_digest_size);
+    return hex_encode(digest, sha1_digest_size);
 }
 
 template <typename V>
@@ -29,6 +60,20 @@ sha1(const V& v) {
     return sha1(s.data(), s.size());
 }
 
+template <typename V>
+size_t
+sha1(const V& v, char* out, size_t cap) {
+    auto s = to_span(v);
+    return sha1(s.data(), s.size(), out, cap);
+}
+
+template <typename V>
+size_t
+sha1(const V& v, std::string& out) {
+    auto s = to_span(v);
+    return sha1(s.data(), s.size(), out);
+}
+
 template <typename V>
 std::string
 sha1sum(const V& v) {
@@ -1,10 +1,19 @@
 #include "strings/aes128.h"
 #include <array>
 #include <stdexcept>
-#include <hwy/highway.h>
 #include <stdint.h>
 #include <string.h>
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "src/aes128.cpp"
+#include <hwy/foreach_target.h>  // IWYU pragma: keep
+
+#include <hwy/highway.h>
+
+HWY_BEFORE_NAMESPACE();
+namespace ss {
+namespace HWY_NAMESPACE {
+
 namespace hn = hwy::HWY_NAMESPACE;
 
 struct aes128 {
@@ -13,24 +22,52 @@ struct aes128 {
 
     inline static HWY_FULL(uint8_t) _d8;
     inline static HWY_FULL(uint32_t) _d32;
+    inline static hn::FixedTag<uint8_t, 16> _d128;
     inline static constexpr size_t N8 = hn::Lanes(_d8);
 
-    static keys_t load_key(std::string_view key) {
+    // Blocks per vector, and vectors kept in flight by the parallel modes so that
+    // at least 8 blocks hide the AESRound latency.
+    inline static constexpr size_t kBlocks = N8 / 16;
+    inline static constexpr size_t kUnroll = HWY_MAX(4, 8 / kBlocks);
+
+    // Round keys as laid out by expand_key(): 20 blocks of 16 bytes.
+    static void expand_key(std::string_view key, uint8_t* round_keys) {
+        const auto key_schedule = load_key(_d128, key);
+        for (size_t i = 0; i < key_schedule.size(); ++i) {
+            hn::Store(key_schedule[i], _d128, round_keys + i * 16);
+        }
+    }
+
+    template <class D>
+    static std::array<hn::Vec<D>, 20> load_schedule(D d, const uint8_t* round_keys) {
+        std::array<hn::Vec<D>, 20> key_schedule;
+        for (size_t i = 0; i < key_schedule.size(); ++i) {
+            key_schedule[i] = hn::LoadDup128(d, round_keys + i * 16);
+        }
+        return key_schedule;
+    }
+
+    static keys_t load_schedule(const uint8_t* round_keys) {
+        return load_schedule(_d8, round_keys);
+    }
+
+    template <class D>
+    static std::array<hn::Vec<D>, 20> load_key(D d, std::string_view key) {
         uint8_t keyb[16] = {0};
         hwy::ZeroBytes(keyb, 16);
         hwy::CopyBytes(key.data(), keyb, HWY_MIN(key.size(), 16));
-        keys_t key_schedule;
-        key_schedule[0]  = hn::LoadDup128(_d8, keyb);
-        key_schedule[1]  = key_expansion<0x01>(key_schedule[0]);
-        key_schedule[2]  = key_expansion<0x02>(key_schedule[1]);
-        key_schedule[3]  = key_expansion<0x04>(key_schedule[2]);
-        key_schedule[4]  = key_expansion<0x08>(key_schedule[3]);
-        key_schedule[5]  = key_expansion<0x10>(key_schedule[4]);
-        key_schedule[6]  = key_expansion<0x20>(key_schedule[5]);
-        key_schedule[7]  = key_expansion<0x40>(key_schedule[6]);
-        key_schedule[8]  = key_expansion<0x80>(key_schedule[7]);
-        key_schedule[9]  = key_expansion<0x1B>(key_schedule[8]);
-        key_schedule[10] = key_expansion<0x36>(key_schedule[9]);
+        std::array<hn::Vec<D>, 20> key_schedule;
+        key_schedule[0]  = hn::LoadDup128(d, keyb);
+        key_schedule[1]  = key_expansion<0x01>(d, key_schedule[0]);
+        key_schedule[2]  = key_expansion<0x02>(d, key_schedule[1]);
+        key_schedule[3]  = key_expansion<0x04>(d, key_schedule[2]);
+        key_schedule[4]  = key_expansion<0x08>(d, key_schedule[3]);
+        key_schedule[5]  = key_expansion<0x10>(d, key_schedule[4]);
+        key_schedule[6]  = key_expansion<0x20>(d, key_schedule[5]);
+        key_schedule[7]  = key_expansion<0x40>(d, key_schedule[6]);
+        key_schedule[8]  = key_expansion<0x80>(d, key_schedule[7]);
+        key_schedule[9]  = key_expansion<0x1B>(d, key_schedule[8]);
+        key_schedule[10] = key_expansion<0x36>(d, key_schedule[9]);
 
         // generate decryption keys in reverse order.
         // k[10] is shared by last encryption and first decryption rounds
@@ -48,30 +85,63 @@ struct aes128 {
         return key_schedule;
     }
 
-    static std::vector<uint8_t>  //
-    encrypt(std::string_view plain, const keys_t& key_schedule) {
-        size_t len        = plain.size();
-        size_t padding    = 16 - (len % 16);
-        char tail_buf[64] = {0};
-        std::vector<uint8_t> result(len + padding);
+    template <class V, class K>
+    static HWY_INLINE V enc_blk(V in, const K& key_schedule) {
+        in = hn::Xor(in, key_schedule[0]);
+        in = hn::AESRound(in, key_schedule[1]);
+        in = hn::AESRound(in, key_schedule[2]);
+        in = hn::AESRound(in, key_schedule[3]);
+        in = hn::AESRound(in, key_schedule[4]);
+        in = hn::AESRound(in, key_schedule[5]);
+        in = hn::AESRound(in, key_schedule[6]);
+        in = hn::AESRound(in, key_schedule[7]);
+        in = hn::AESRound(in, key_schedule[8]);
+        in = hn::AESRound(in, key_schedule[9]);
+        in = hn::AESLastRound(in, key_schedule[10]);
+        return in;
+    }
+
+    template <class V, class K>
+    static HWY_INLINE V dec_blk(V in, const K& key_schedule) {
+        in = hn::Xor(in, key_schedule[10]);
+        in = hn::AESRoundInv(in, key_schedule[11]);
+        in = hn::AESRoundInv(in, key_schedule[12]);
+        in = hn::AESRoundInv(in, key_schedule[13]);
+        in = hn::AESRoundInv(in, key_schedule[14]);
+        in = hn::AESRoundInv(in, key_schedule[15]);
+        in = hn::AESRoundInv(in, key_schedule[16]);
+        in = hn::AESRoundInv(in, key_schedule[17]);
+        in = hn::AESRoundInv(in, key_schedule[18]);
+        in = hn::AESRoundInv(in, key_schedule[19]);
+        return hn::AESLastRoundInv(in, key_schedule[0]);
+    }
+
+    // Round-major over U independent vectors, so consecutive AESRound calls do not
+    // depend on each other.
+    template <size_t U>
+    static HWY_INLINE void enc_blks(std::array<vec_t, U>& v, const keys_t& key_schedule) {
+        for (size_t u = 0; u < U; ++u) v[u] = hn::Xor(v[u], key_schedule[0]);
+        for (size_t r = 1; r < 10; ++r) {
+            for (size_t u = 0; u < U; ++u) v[u] = hn::AESRound(v[u], key_schedule[r]);
+        }
+        for (size_t u = 0; u < U; ++u) v[u] = hn::AESLastRound(v[u], key_schedule[10]);
+    }
+
+    template <size_t U>
+    static HWY_INLINE void dec_blks(std::array<vec_t, U>& v, const keys_t& key_schedule) {
+        for (size_t u = 0; u < U; ++u) v[u] = hn::Xor(v[u], key_schedule[10]);
+        for (size_t r = 11; r < 20; ++r) {
+            for (size_t u = 0; u < U; ++u) v[u] = hn::AESRoundInv(v[u], key_schedule[r]);
+        }
+        for (size_t u = 0; u < U; ++u) v[u] = hn::AESLastRoundInv(v[u], key_schedule[0]);
+    }
+
+    static size_t encrypt(std::string_view plain, const keys_t& key_schedule, uint8_t* dest) {
+        size_t len         = plain.size();
+        size_t padding     = 16 - (len % 16);
+        char tail_buf[64]  = {0};
         size_t idx         = 0;
         const uint8_t* src = reinterpret_cast<const uint8_t*>(plain.data());
-        uint8_t* dest      = reinterpret_cast<uint8_t*>(result.data());
-
-        static constexpr auto enc_blk = [](auto in, const auto& key_schedule) {
-            in = hn::Xor(in, key_schedule[0]);
-            in = hn::AESRound(in, key_schedule[1]);
-            in = hn::AESRound(in, key_schedule[2]);
-            in = hn::AESRound(in, key_schedule[3]);
-            in = hn::AESRound(in, key_schedule[4]);
-            in = hn::AESRound(in, key_schedule[5]);
-            in = hn::AESRound(in, key_schedule[6]);
-            in = hn::AESRound(in, key_schedule[7]);
-            in = hn::AESRound(in, key_schedule[8]);
-            in = hn::AESRound(in, key_schedule[9]);
-            in = hn::AESLastRound(in, key_schedule[10]);
-            return in;
-        };
 
         while (idx + N8 - 1 < len) {
             auto in = hn::LoadU(_d8, src + idx);
@@ -93,39 +163,17 @@ struct aes128 {
         in      = enc_blk(in, key_schedule);
         hn::StoreN(in, _d8, dest + idx, remaining + padding);
 
-        return result;
-    }
-
-    static inline std::vector<uint8_t>  //
-    encrypt(std::string_view plain, std::string_view key) {
-        return encrypt(plain, load_key(key));
+        return len + padding;
     }
 
-    static std::vector<uint8_t>  //
-    decrypt(std::string_view cipher, const keys_t& key_schedule) {
+    static size_t decrypt(std::string_view cipher, const keys_t& key_schedule, uint8_t* dest) {
         size_t len = cipher.size();
-        if (HWY_UNLIKELY(len % 16 != 0)) {
+        if (HWY_UNLIKELY(len == 0 || len % 16 != 0)) {
             throw std::runtime_error("Invalid aes128 size");
         }
-        size_t idx = 0;
-        std::vector<uint8_t> result(len);
-        uint8_t* dest      = reinterpret_cast<uint8_t*>(&result[0]);
+        size_t idx         = 0;
         const uint8_t* src = reinterpret_cast<const uint8_t*>(cipher.data());
 
-        static constexpr auto dec_blk = [](vec_t in, const keys_t& key_schedule) {
-            in = hn::Xor(in, key_schedule[10]);
-            in = hn::AESRoundInv(in, key_schedule[11]);
-            in = hn::AESRoundInv(in, key_schedule[12]);
-            in = hn::AESRoundInv(in, key_schedule[13]);
-            in = hn::AESRoundInv(in, key_schedule[14]);
-            in = hn::AESRoundInv(in, key_schedule[15]);
-            in = hn::AESRoundInv(in, key_schedule[16]);
-            in = hn::AESRoundInv(in, key_schedule[17]);
-            in = hn::AESRoundInv(in, key_schedule[18]);
-            in = hn::AESRoundInv(in, key_schedule[19]);
-            return hn::AESLastRoundInv(in, key_schedule[0]);
-        };
-
         while (idx + N8 - 1 < len) {
             auto in = hn::LoadU(_d8, src + idx);
             in      = dec_blk(in, key_schedule);
@@ -140,21 +188,153 @@ struct aes128 {
             hn::StoreN(in, _d8, dest + idx, remaining);
         }
 
-        auto padding = (int)result[len - 1];
-        result.resize(len - padding);
-        return result;
+        auto padding = (size_t)dest[len - 1];
+        if (HWY_UNLIKELY(padding == 0 || padding > 16)) {
+            throw std::runtime_error("Invalid aes128 padding");
+        }
+        return len - padding;
+    }
+
+    // Adds `n` to the 128-bit big-endian counter block.
+    static void ctr_add(uint8_t* ctr, uint64_t n) {
+        for (int i = 15; i >= 0 && n != 0; --i) {
+            n += ctr[i];
+            ctr[i] = (uint8_t)n;
+            n >>= 8;
+        }
     }
 
-    static std::vector<uint8_t>  //
-    decrypt(std::string_view cipher, std::string_view key) {
-        return decrypt(cipher, load_key(key));
+    // Counter blocks ctr, ctr+1, ... one vector at a time. The low 32-bit word
+    // is kept byte-swapped so each step is a single u32 add; only valid while that
+    // word does not wrap.
+    struct ctr32_blocks {
+        hn::Vec<HWY_FULL(uint32_t)> cur, step;
+        vec_t swap;
+
+        explicit ctr32_blocks(const uint8_t* ctr) {
+            HWY_ALIGN static constexpr uint8_t kSwap[16] = {0, 1, 2,  3,  4,  5,  6,  7,
+                                                            8, 9, 10, 11, 15, 14, 13, 12};
+            swap            = hn::LoadDup128(_d8, kSwap);
+            const auto lane = hn::Iota(_d32, 0);
+            const auto low  = hn::Eq(hn::And(lane, hn::Set(_d32, 3)), hn::Set(_d32, 3));
+            cur  = hn::BitCast(_d32, hn::TableLookupBytes(hn::LoadDup128(_d8, ctr), swap));
+            cur  = hn::Add(cur, hn::IfThenElseZero(low, hn::ShiftRight<2>(lane)));
+            step = hn::IfThenElseZero(low, hn::Set(_d32, (uint32_t)kBlocks));
+        }
+
+        HWY_INLINE vec_t next() {
+            auto r = hn::TableLookupBytes(hn::BitCast(_d8, cur), swap);
+            cur    = hn::Add(cur, step);
+            return r;
+        }
+    };
+
+    // Generic fallback for the (rare) carry out of the low word.
+    struct ctr128_blocks {
+        uint8_t ctr[16];
+
+        explicit ctr128_blocks(const uint8_t* c) { hwy::CopyBytes<16>(c, ctr); }
+
+        HWY_INLINE vec_t next() {
+            HWY_ALIGN uint8_t buf[N8];
+            for (size_t i = 0; i < kBlocks; ++i) {
+                hwy::CopyBytes<16>(ctr, buf + i * 16);
+                ctr_add(ctr, 1);
+            }
+            return hn::Load(_d8, buf);
+        }
+    };
+
+    template <class Blocks>
+    static void ctr_xor(const uint8_t* src, size_t len, const keys_t& key_schedule,
+                        Blocks blocks, uint8_t* dest) {
+        size_t idx = 0;
+        for (; idx + kUnroll * N8 <= len; idx += kUnroll * N8) {
+            std::array<vec_t, kUnroll> v;
+            for (size_t u = 0; u < kUnroll; ++u) v[u] = blocks.next();
+            enc_blks(v, key_schedule);
+            for (size_t u = 0; u < kUnroll; ++u) {
+                auto in = hn::LoadU(_d8, src + idx + u * N8);
+                hn::StoreU(hn::Xor(in, v[u]), _d8, dest + idx + u * N8);
+            }
+        }
+        for (; idx < len; idx += N8) {
+            const size_t n = HWY_MIN(N8, len - idx);
+            auto ks        = enc_blk(blocks.next(), key_schedule);
+            auto in        = hn::LoadN(_d8, src + idx, n);
+            hn::StoreN(hn::Xor(in, ks), _d8, dest + idx, n);
+        }
+    }
+
+    // CTR mode, `ctr` is advanced past the last (possibly partial) block.
+    static void ctr(const uint8_t* src, size_t len, const keys_t& key_schedule, uint8_t* ctr,
+                    uint8_t* dest) {
+        const uint64_t nblocks = (len + 15) / 16;
+        const uint32_t low     = (uint32_t)ctr[12] << 24 | (uint32_t)ctr[13] << 16 |
+                             (uint32_t)ctr[14] << 8 | ctr[15];
+        // Round up to whole vectors, the last one may generate unused blocks.
+        const uint64_t generated = (nblocks + kBlocks - 1) / kBlocks * kBlocks;
+        if (HWY_LIKELY(low + generated <= 0xFFFFFFFFull)) {
+            ctr_xor(src, len, key_schedule, ctr32_blocks(ctr), dest);
+        } else {
+            ctr_xor(src, len, key_schedule, ctr128_blocks(ctr), dest);
+        }
+        ctr_add(ctr, nblocks);
+    }
+
+    // CBC encryption is a serial chain, one 128-bit block at a time.
+    static void cbc_encrypt(const uint8_t* src, size_t len, const uint8_t* round_keys,
+                            const uint8_t* iv, uint8_t* dest) {
+        if (HWY_UNLIKELY(len % 16 != 0)) {
+            throw std::runtime_error("Invalid aes128 size");
+        }
+        const auto key_schedule = load_schedule(_d128, round_keys);
+        auto chain              = hn::LoadU(_d128, iv);
+        for (size_t idx = 0; idx < len; idx += 16) {
+            chain = enc_blk(hn::Xor(chain, hn::LoadU(_d128, src + idx)), key_schedule);
+            hn::StoreU(chain, _d128, dest + idx);
+        }
+    }
+
+    // CBC decryption is parallel: P[i] = D(C[i]) ^ C[i-1]. The previous ciphertext
+    // blocks are built from registers, so `dest` may alias `src`.
+    static void cbc_decrypt(const uint8_t* src, size_t len, const keys_t& key_schedule,
+                            const uint8_t* iv, uint8_t* dest) {
+        if (HWY_UNLIKELY(len % 16 != 0)) {
+            throw std::runtime_error("Invalid aes128 size");
+        }
+        // Shifts in the last block of `prev` below the first block of `c`.
+        static constexpr auto shifted = [](vec_t prev, vec_t c) {
+            return hn::Or(hn::SlideUpLanes(_d8, c, 16), hn::SlideDownLanes(_d8, prev, N8 - 16));
+        };
+
+        auto prev  = hn::LoadDup128(_d8, iv);
+        size_t idx = 0;
+        for (; idx + kUnroll * N8 <= len; idx += kUnroll * N8) {
+            std::array<vec_t, kUnroll> c, v;
+            for (size_t u = 0; u < kUnroll; ++u) c[u] = v[u] = hn::LoadU(_d8, src + idx + u * N8);
+            dec_blks(v, key_schedule);
+            for (size_t u = 0; u < kUnroll; ++u) {
+                hn::StoreU(hn::Xor(v[u], shifted(u == 0 ? prev : c[u - 1], c[u])), _d8,
+                           dest + idx + u * N8);
+            }
+            prev = c[kUnroll - 1];
+        }
+        for (; idx < len; idx += N8) {
+            const size_t n = HWY_MIN(N8, len - idx);
+            auto c         = hn::LoadN(_d8, src + idx, n);
+            auto v         = dec_blk(c, key_schedule);
+            hn::StoreN(hn::Xor(v, shifted(prev, c)), _d8, dest + idx, n);
+            prev = c;
+        }
     }
 
 private:
-    template <uint8_t Rcon>
-    static vec_t key_expansion(vec_t key) {
+    template <uint8_t Rcon, class D>
+    static hn::Vec<D> key_expansion(D d, hn::Vec<D> key) {
+        const hn::Repartition<uint32_t, D> d32;
         auto keygened = hn::AESKeyGenAssist<Rcon>(key);
-        keygened      = hn::BitCast(_d8, hn::Broadcast<3>(hn::BitCast(_d32, keygened)));
+        keygened      = hn::BitCast(d, hn::Broadcast<3>(hn::BitCast(d32, keygened)));
         key           = hn::Xor(key, hn::ShiftLeftBytes<4>(key));
         key           = hn::Xor(key, hn::ShiftLeftBytes<4>(key));
         key           = hn::Xor(key, hn::ShiftLeftBytes<4>(key));
@@ -163,16 +343,685 @@ private:
     }
 };
 
+// GHASH on byte-reflected blocks (Gueron & Kounavis, Intel CLMUL white paper),
+// one GCM block per 128-bit SIMD block. A run of blocks is multiplied by
+// descending powers of H and summed before a single reduction.
+struct ghash {
+    using vec_t = aes128::vec_t;
+
+    inline static HWY_FULL(uint64_t) _d64;
+    inline static hn::FixedTag<uint64_t, 2> _d128_64;
+    inline static constexpr size_t N8 = aes128::N8;
+
+    // The table holds H^kPowers .. H^1, followed by zero blocks so that a partial
+    // vector of powers never reads past it.
+    inline static constexpr size_t kPowers = 16;
+    inline static constexpr size_t kChunk  = aes128::kUnroll * aes128::kBlocks;
+    static_assert(kChunk <= kPowers && aes128::kBlocks <= 4, "aes128_gcm_key table size");
+
+    template <class D>
+    static HWY_INLINE hn::Vec<D> reflect(D d, hn::Vec<D> v) {
+        HWY_ALIGN static constexpr uint8_t kReverse[16] = {15, 14, 13, 12, 11, 10, 9, 8,
+                                                           7,  6,  5,  4,  3,  2,  1, 0};
+        return hn::TableLookupBytes(v, hn::LoadDup128(d, kReverse));
+    }
+
+    template <class D, class V = hn::Vec<D>>
+    static HWY_INLINE void mul_acc(D d, V a, V b, V& lo, V& mid, V& hi) {
+        const V b_swapped = hn::Reverse2(d, b);
+        lo  = hn::Xor(lo, hn::CLMulLower(a, b));
+        hi  = hn::Xor(hi, hn::CLMulUpper(a, b));
+        mid = hn::Xor(mid, hn::Xor(hn::CLMulLower(a, b_swapped), hn::CLMulUpper(a, b_swapped)));
+    }
+
+    template <class D, class V = hn::Vec<D>>
+    static HWY_INLINE V reduce(D d, V lo, V mid, V hi) {
+        const hn::Repartition<uint32_t, D> d32;
+        auto t3 = hn::BitCast(d32, hn::Xor(lo, hn::ShiftLeftBytes<8>(d, mid)));
+        auto t6 = hn::BitCast(d32, hn::Xor(hi, hn::ShiftRightBytes<8>(d, mid)));
+
+        // The reflected product is one bit short, shift the 256 bits left by one.
+        auto t7 = hn::ShiftRight<31>(t3);
+        auto t8 = hn::ShiftRight<31>(t6);
+        auto t9 = hn::ShiftRightBytes<12>(d32, t7);
+        t3      = hn::Or(hn::ShiftLeft<1>(t3), hn::ShiftLeftBytes<4>(d32, t7));
+        t6      = hn::Or(hn::Or(hn::ShiftLeft<1>(t6), hn::ShiftLeftBytes<4>(d32, t8)), t9);
+
+        // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+        t7 = hn::Xor(hn::Xor(hn::ShiftLeft<31>(t3), hn::ShiftLeft<30>(t3)), hn::ShiftLeft<25>(t3));
+        t8 = hn::ShiftRightBytes<4>(d32, t7);
+        t3 = hn::Xor(t3, hn::ShiftLeftBytes<12>(d32, t7));
+        auto t2 = hn::Xor(hn::ShiftRight<1>(t3), hn::ShiftRight<2>(t3));
+        t2      = hn::Xor(hn::Xor(t2, hn::ShiftRight<7>(t3)), t8);
+        return hn::BitCast(d, hn::Xor(t6, hn::Xor(t3, t2)));
+    }
+
+    static void init(const uint8_t* round_keys, uint8_t* htable) {
+        const auto& d8 = aes128::_d128;
+        const auto key_schedule = aes128::load_schedule(d8, round_keys);
+        const auto h0           = aes128::enc_blk(hn::Zero(d8), key_schedule);
+        const auto h            = hn::BitCast(_d128_64, reflect(d8, h0));
+        auto p = h;
+        for (size_t i = 0; i < kPowers; ++i) {
+            hn::Store(hn::BitCast(d8, p), d8, htable + (kPowers - 1 - i) * 16);
+            auto lo = hn::Zero(_d128_64), mid = lo, hi = lo;
+            mul_acc(_d128_64, p, h, lo, mid, hi);
+            p = reduce(_d128_64, lo, mid, hi);
+        }
+        hwy::ZeroBytes(htable + kPowers * 16, 4 * 16);
+    }
+
+    // y = (y ^ x[0]) * H^n ^ x[1] * H^(n-1) ^ ... for the first `nblocks` blocks of
+    // the reflected vectors `x`; blocks past that must be zero.
+    static HWY_INLINE void fold(uint8_t* y, const vec_t* x, size_t nvec, size_t nblocks,
+                                const uint8_t* htable) {
+        const uint8_t* powers = htable + (kPowers - nblocks) * 16;
+        auto lo = hn::Zero(_d64), mid = lo, hi = lo;
+        for (size_t u = 0; u < nvec; ++u) {
+            auto a = x[u];
+            if (u == 0) {
+                a = hn::Xor(a, hn::LoadN(aes128::_d8, y, 16));
+            }
+            mul_acc(_d64, hn::BitCast(_d64, a),
+                    hn::BitCast(_d64, hn::LoadU(aes128::_d8, powers + u * N8)), lo, mid, hi);
+        }
+        HWY_ALIGN uint8_t blocks[N8];
+        hn::Store(hn::BitCast(aes128::_d8, reduce(_d64, lo, mid, hi)), aes128::_d8, blocks);
+        auto acc = hn::Load(aes128::_d128, blocks);
+        for (size_t i = 1; i < aes128::kBlocks; ++i) {
+            acc = hn::Xor(acc, hn::Load(aes128::_d128, blocks + i * 16));
+        }
+        hn::StoreU(acc, aes128::_d128, y);
+    }
+
+    // GHASH of `len` bytes, the last block zero-padded.
+    static void update(const uint8_t* src, size_t len, const uint8_t* htable, uint8_t* y) {
+        const auto& d8 = aes128::_d8;
+        std::array<vec_t, aes128::kUnroll> x;
+        size_t idx = 0;
+        for (; idx + kChunk * 16 <= len; idx += kChunk * 16) {
+            for (size_t u = 0; u < x.size(); ++u) {
+                x[u] = reflect(d8, hn::LoadU(d8, src + idx + u * N8));
+            }
+            fold(y, x.data(), x.size(), kChunk, htable);
+        }
+        if (idx != len) {
+            const size_t remaining = len - idx;
+            const size_t nvec      = (remaining + N8 - 1) / N8;
+            for (size_t u = 0; u < nvec; ++u) {
+                const size_t n = HWY_MIN(N8, remaining - u * N8);
+                x[u]           = reflect(d8, hn::LoadN(d8, src + idx + u * N8, n));
+            }
+            fold(y, x.data(), nvec, (remaining + 15) / 16, htable);
+        }
+    }
+};
+
+// GCM counter mode (32-bit wrapping increment) fused with GHASH of the
+// ciphertext; each chunk is encrypted and then folded while still in registers.
+// `y` may be null to produce keystream only.
+static void gcm_crypt(const uint8_t* src, size_t len, const uint8_t* round_keys,
+                      const uint8_t* htable, uint8_t* ctr, uint8_t* y, bool decrypt,
+                      uint8_t* dest) {
+    using vec_t        = aes128::vec_t;
+    constexpr size_t N = aes128::N8;
+    const auto& d8     = aes128::_d8;
+
+    const auto key_schedule = aes128::load_schedule(round_keys);
+    aes128::ctr32_blocks blocks(ctr);
+    std::array<vec_t, aes128::kUnroll> v, x;
+    size_t idx = 0;
+    for (; idx + aes128::kUnroll * N <= len; idx += aes128::kUnroll * N) {
+        for (size_t u = 0; u < v.size(); ++u) v[u] = blocks.next();
+        aes128::enc_blks(v, key_schedule);
+        for (size_t u = 0; u < v.size(); ++u) {
+            const auto in  = hn::LoadU(d8, src + idx + u * N);
+            const auto out = hn::Xor(in, v[u]);
+            hn::StoreU(out, d8, dest + idx + u * N);
+            x[u] = ghash::reflect(d8, decrypt ? in : out);
+        }
+        if (y) {
+            ghash::fold(y, x.data(), x.size(), ghash::kChunk, htable);
+        }
+    }
+    if (idx != len) {
+        const size_t remaining = len - idx;
+        const size_t nvec      = (remaining + N - 1) / N;
+        for (size_t u = 0; u < nvec; ++u) {
+            const size_t n = HWY_MIN(N, remaining - u * N);
+            const auto in  = hn::LoadN(d8, src + idx + u * N, n);
+            auto out       = hn::Xor(in, aes128::enc_blk(blocks.next(), key_schedule));
+            hn::StoreN(out, d8, dest + idx + u * N, n);
+            out  = hn::IfThenElseZero(hn::FirstN(d8, n), out);
+            x[u] = ghash::reflect(d8, decrypt ? in : out);
+        }
+        if (y) {
+            ghash::fold(y, x.data(), nvec, (remaining + 15) / 16, htable);
+        }
+    }
+
+    uint32_t low = (uint32_t)ctr[12] << 24 | (uint32_t)ctr[13] << 16 | (uint32_t)ctr[14] << 8 |
+                   ctr[15];
+    low += (uint32_t)((len + 15) / 16);
+    ctr[12] = (uint8_t)(low >> 24);
+    ctr[13] = (uint8_t)(low >> 16);
+    ctr[14] = (uint8_t)(low >> 8);
+    ctr[15] = (uint8_t)low;
+}
+
+void Aes128ExpandKey(const char* key, size_t key_size, uint8_t* round_keys) {
+    aes128::expand_key(std::string_view(key, key_size), round_keys);
+}
+
+size_t Aes128Encrypt(const char* plain, size_t plain_size, const uint8_t* round_keys,
+                     char* out) {
+    return aes128::encrypt(std::string_view(plain, plain_size),
+                           aes128::load_schedule(round_keys), (uint8_t*)out);
+}
+
+size_t Aes128Decrypt(const char* cipher, size_t cipher_size, const uint8_t* round_keys,
+                     char* out) {
+    return aes128::decrypt(std::string_view(cipher, cipher_size),
+                           aes128::load_schedule(round_keys), (uint8_t*)out);
+}
+
+void Aes128Ctr(const char* in, size_t len, const uint8_t* round_keys, uint8_t* ctr, char* out) {
+    aes128::ctr((const uint8_t*)in, len, aes128::load_schedule(round_keys), ctr,
+                (uint8_t*)out);
+}
+
+void Aes128CbcEncrypt(const char* in, size_t len, const uint8_t* round_keys, const char* iv,
+                      char* out) {
+    aes128::cbc_encrypt((const uint8_t*)in, len, round_keys, (const uint8_t*)iv,
+                        (uint8_t*)out);
+}
+
+void Aes128CbcDecrypt(const char* in, size_t len, const uint8_t* round_keys, const char* iv,
+                      char* out) {
+    aes128::cbc_decrypt((const uint8_t*)in, len, aes128::load_schedule(round_keys),
+                        (const uint8_t*)iv, (uint8_t*)out);
+}
+
+void Aes128GcmInit(const uint8_t* round_keys, uint8_t* htable) {
+    ghash::init(round_keys, htable);
+}
+
+void Aes128GcmHash(const char* in, size_t len, const uint8_t* htable, uint8_t* y) {
+    ghash::update((const uint8_t*)in, len, htable, y);
+}
+
+void Aes128GcmCrypt(const char* in, size_t len, const uint8_t* round_keys,
+                    const uint8_t* htable, uint8_t* ctr, uint8_t* y, bool decrypt, char* out) {
+    gcm_crypt((const uint8_t*)in, len, round_keys, htable, ctr, y, decrypt, (uint8_t*)out);
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+
 namespace ss {
 
+HWY_EXPORT(Aes128ExpandKey);
+HWY_EXPORT(Aes128Encrypt);
+HWY_EXPORT(Aes128Decrypt);
+HWY_EXPORT(Aes128Ctr);
+HWY_EXPORT(Aes128CbcEncrypt);
+HWY_EXPORT(Aes128CbcDecrypt);
+HWY_EXPORT(Aes128GcmInit);
+HWY_EXPORT(Aes128GcmHash);
+HWY_EXPORT(Aes128GcmCrypt);
+
+aes128_key::aes128_key(const char* key, size_t key_size) {
+    HWY_DYNAMIC_DISPATCH(Aes128ExpandKey)(key, key_size, round_keys_);
+}
+
+size_t aes128_enc(const char* plain, size_t plain_size, const aes128_key& key, char* out,
+                  size_t cap) {
+    if (HWY_UNLIKELY(cap < aes128_enc_size(plain, plain_size))) {
+        throw std::length_error("Output buffer too small");
+    }
+    return HWY_DYNAMIC_DISPATCH(Aes128Encrypt)(plain, plain_size, key.round_keys(), out);
+}
+
+size_t aes128_dec(const char* cipher, size_t cipher_size, const aes128_key& key, char* out,
+                  size_t cap) {
+    if (HWY_UNLIKELY(cap < aes128_dec_size(cipher, cipher_size))) {
+        throw std::length_error("Output buffer too small");
+    }
+    return HWY_DYNAMIC_DISPATCH(Aes128Decrypt)(cipher, cipher_size, key.round_keys(), out);
+}
+
+size_t aes128_enc(const char* plain, size_t plain_size, const aes128_key& key,
+                  std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + aes128_enc_size(plain, plain_size));
+    return HWY_DYNAMIC_DISPATCH(Aes128Encrypt)(plain, plain_size, key.round_keys(), &out[pos]);
+}
+
+size_t aes128_dec(const char* cipher, size_t cipher_size, const aes128_key& key,
+                  std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + aes128_dec_size(cipher, cipher_size));
+    try {
+        auto n =
+            HWY_DYNAMIC_DISPATCH(Aes128Decrypt)(cipher, cipher_size, key.round_keys(), &out[pos]);
+        out.resize(pos + n);
+        return n;
+    } catch (...) {
+        out.resize(pos);
+        throw;
+    }
+}
+
+std::vector<uint8_t> aes128_enc(const char* plain, size_t plain_size, const aes128_key& key) {
+    std::vector<uint8_t> result(aes128_enc_size(plain, plain_size));
+    HWY_DYNAMIC_DISPATCH(Aes128Encrypt)(plain, plain_size, key.round_keys(),
+                                        (char*)result.data());
+    return result;
+}
+
+std::vector<uint8_t> aes128_dec(const char* cipher, size_t cipher_size, const aes128_key& key) {
+    std::vector<uint8_t> result(aes128_dec_size(cipher, cipher_size));
+    auto n = HWY_DYNAMIC_DISPATCH(Aes128Decrypt)(cipher, cipher_size, key.round_keys(),
+                                                 (char*)result.data());
+    result.resize(n);
+    return result;
+}
+
+size_t aes128_enc(const char* plain, size_t plain_size, const char* key, size_t key_size,
+                  char* out, size_t cap) {
+    return aes128_enc(plain, plain_size, aes128_key(key, key_size), out, cap);
+}
+
+size_t aes128_dec(const char* cipher, size_t cipher_size, const char* key, size_t key_size,
+                  char* out, size_t cap) {
+    return aes128_dec(cipher, cipher_size, aes128_key(key, key_size), out, cap);
+}
+
+size_t aes128_enc(const char* plain, size_t plain_size, const char* key, size_t key_size,
+                  std::string& out) {
+    return aes128_enc(plain, plain_size, aes128_key(key, key_size), out);
+}
+
+size_t aes128_dec(const char* cipher, size_t cipher_size, const char* key, size_t key_size,
+                  std::string& out) {
+    return aes128_dec(cipher, cipher_size, aes128_key(key, key_size), out);
+}
+
 std::vector<uint8_t>
 aes128_enc(const char* plain, size_t plain_size, const char* key, size_t key_size) {
-    return aes128::encrypt(std::string_view(plain, plain_size), std::string_view(key, key_size));
+    return aes128_enc(plain, plain_size, aes128_key(key, key_size));
 }
 
 std::vector<uint8_t>
 aes128_dec(const char* cipher, size_t cipher_size, const char* key, size_t key_size) {
-    return aes128::decrypt(std::string_view(cipher, cipher_size), std::string_view(key, key_size));
+    return aes128_dec(cipher, cipher_size, aes128_key(key, key_size));
+}
+
+void aes128_ctr(const char* in, size_t len, const aes128_key& key, const char* iv, char* out) {
+    uint8_t ctr[16];
+    memcpy(ctr, iv, 16);
+    HWY_DYNAMIC_DISPATCH(Aes128Ctr)(in, len, key.round_keys(), ctr, out);
+}
+
+void aes128_cbc_enc(const char* in, size_t len, const aes128_key& key, const char* iv,
+                    char* out) {
+    HWY_DYNAMIC_DISPATCH(Aes128CbcEncrypt)(in, len, key.round_keys(), iv, out);
+}
+
+void aes128_cbc_dec(const char* in, size_t len, const aes128_key& key, const char* iv,
+                    char* out) {
+    HWY_DYNAMIC_DISPATCH(Aes128CbcDecrypt)(in, len, key.round_keys(), iv, out);
+}
+
+size_t aes128_ctr(const char* in, size_t len, const aes128_key& key, const char* iv,
+                  std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + len);
+    aes128_ctr(in, len, key, iv, &out[pos]);
+    return len;
+}
+
+size_t aes128_cbc_enc(const char* in, size_t len, const aes128_key& key, const char* iv,
+                      std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + len);
+    try {
+        aes128_cbc_enc(in, len, key, iv, &out[pos]);
+        return len;
+    } catch (...) {
+        out.resize(pos);
+        throw;
+    }
+}
+
+size_t aes128_cbc_dec(const char* in, size_t len, const aes128_key& key, const char* iv,
+                      std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + len);
+    try {
+        aes128_cbc_dec(in, len, key, iv, &out[pos]);
+        return len;
+    } catch (...) {
+        out.resize(pos);
+        throw;
+    }
+}
+
+void aes128_ctr(const char* in, size_t len, const char* key, size_t key_size, const char* iv,
+                char* out) {
+    aes128_ctr(in, len, aes128_key(key, key_size), iv, out);
+}
+
+size_t aes128_ctr(const char* in, size_t len, const char* key, size_t key_size, const char* iv,
+                  std::string& out) {
+    return aes128_ctr(in, len, aes128_key(key, key_size), iv, out);
+}
+
+void aes128_cbc_enc(const char* in, size_t len, const char* key, size_t key_size,
+                    const char* iv, char* out) {
+    aes128_cbc_enc(in, len, aes128_key(key, key_size), iv, out);
+}
+
+void aes128_cbc_dec(const char* in, size_t len, const char* key, size_t key_size,
+                    const char* iv, char* out) {
+    aes128_cbc_dec(in, len, aes128_key(key, key_size), iv, out);
+}
+
+size_t aes128_cbc_enc(const char* in, size_t len, const char* key, size_t key_size,
+                      const char* iv, std::string& out) {
+    return aes128_cbc_enc(in, len, aes128_key(key, key_size), iv, out);
+}
+
+size_t aes128_cbc_dec(const char* in, size_t len, const char* key, size_t key_size,
+                      const char* iv, std::string& out) {
+    return aes128_cbc_dec(in, len, aes128_key(key, key_size), iv, out);
+}
+
+aes128_ctr_stream::aes128_ctr_stream(const aes128_key& key, const char* iv)
+  : key_(key), nkeystream_(0) {
+    memcpy(ctr_, iv, 16);
+}
+
+aes128_ctr_stream::aes128_ctr_stream(const char* key, size_t key_size, const char* iv)
+  : aes128_ctr_stream(aes128_key(key, key_size), iv) {}
+
+void aes128_ctr_stream::update(const char* in, size_t len, char* out) {
+    auto xor_keystream = [&](size_t n) {
+        const uint8_t* ks = keystream_ + 16 - nkeystream_;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = (char)(in[i] ^ ks[i]);
+        }
+        nkeystream_ -= n;
+        in += n;
+        out += n;
+        len -= n;
+    };
+
+    xor_keystream(len < nkeystream_ ? len : nkeystream_);
+    const size_t bulk = len / 16 * 16;
+    if (bulk != 0) {
+        HWY_DYNAMIC_DISPATCH(Aes128Ctr)(in, bulk, key_.round_keys(), ctr_, out);
+        in += bulk;
+        out += bulk;
+        len -= bulk;
+    }
+    if (len != 0) {
+        // Keep the rest of this block's keystream for the next update.
+        memset(keystream_, 0, 16);
+        HWY_DYNAMIC_DISPATCH(Aes128Ctr)((const char*)keystream_, 16, key_.round_keys(), ctr_,
+                                        (char*)keystream_);
+        nkeystream_ = 16;
+        xor_keystream(len);
+    }
+}
+
+size_t aes128_ctr_stream::update(const char* in, size_t len, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + len);
+    update(in, len, &out[pos]);
+    return len;
+}
+
+aes128_gcm_key::aes128_gcm_key(const aes128_key& key) : key_(key) {
+    HWY_DYNAMIC_DISPATCH(Aes128GcmInit)(key_.round_keys(), htable_);
+}
+
+aes128_gcm_key::aes128_gcm_key(const char* key, size_t key_size)
+  : aes128_gcm_key(aes128_key(key, key_size)) {}
+
+namespace {
+
+void store_be64(uint8_t* out, uint64_t v) {
+    for (int i = 7; i >= 0; --i, v >>= 8) {
+        out[i] = (uint8_t)v;
+    }
+}
+
+}  // namespace
+
+aes128_gcm_stream::aes128_gcm_stream(const aes128_gcm_key& key, const char* iv, size_t iv_size)
+  : key_(&key), npending_(0), aad_size_(0), text_size_(0), text_started_(false) {
+    if (HWY_UNLIKELY(iv_size == 0)) {
+        throw std::runtime_error("Invalid aes128-gcm iv size");
+    }
+    memset(ghash_, 0, 16);
+    if (iv_size == 12) {
+        memcpy(j0_, iv, 12);
+        memcpy(j0_ + 12, "\0\0\0\1", 4);
+    } else {
+        uint8_t lengths[16] = {0};
+        store_be64(lengths + 8, (uint64_t)iv_size * 8);
+        HWY_DYNAMIC_DISPATCH(Aes128GcmHash)(iv, iv_size, key.htable(), ghash_);
+        HWY_DYNAMIC_DISPATCH(Aes128GcmHash)((const char*)lengths, 16, key.htable(), ghash_);
+        for (int i = 0; i < 16; ++i) {
+            j0_[i] = ghash_[15 - i];
+        }
+        memset(ghash_, 0, 16);
+    }
+    // Text starts at inc32(J0), J0 itself masks the tag.
+    memcpy(ctr_, j0_, 16);
+    for (int i = 15; i >= 12 && ++ctr_[i] == 0; --i) {}
+}
+
+void aes128_gcm_stream::hash_pending() {
+    if (npending_ != 0) {
+        HWY_DYNAMIC_DISPATCH(Aes128GcmHash)((const char*)pending_, npending_, key_->htable(),
+                                            ghash_);
+        npending_ = 0;
+    }
+}
+
+void aes128_gcm_stream::aad(const char* buf, size_t len) {
+    if (HWY_UNLIKELY(text_started_)) {
+        throw std::logic_error("aes128-gcm aad after text");
+    }
+    aad_size_ += len;
+    if (npending_ != 0) {
+        const size_t n = HWY_MIN(len, 16 - npending_);
+        memcpy(pending_ + npending_, buf, n);
+        npending_ += n;
+        buf += n;
+        len -= n;
+        if (npending_ != 16) {
+            return;
+        }
+        hash_pending();
+    }
+    const size_t bulk = len / 16 * 16;
+    HWY_DYNAMIC_DISPATCH(Aes128GcmHash)(buf, bulk, key_->htable(), ghash_);
+    memcpy(pending_, buf + bulk, len - bulk);
+    npending_ = len - bulk;
+}
+
+void aes128_gcm_stream::crypt(const char* in, size_t len, char* out, bool decrypt) {
+    if (!text_started_) {
+        // Close the padded aad block before the first text block.
+        hash_pending();
+        text_started_ = true;
+    }
+    text_size_ += len;
+
+    auto xor_keystream = [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t c       = (uint8_t)in[i];
+            const uint8_t r       = c ^ keystream_[npending_ + i];
+            out[i]                = (char)r;
+            pending_[npending_ + i] = decrypt ? c : r;
+        }
+        npending_ += n;
+        in += n;
+        out += n;
+        len -= n;
+    };
+
+    if (npending_ != 0) {
+        xor_keystream(HWY_MIN(len, 16 - npending_));
+        if (npending_ == 16) {
+            hash_pending();
+        }
+    }
+    const size_t bulk = len / 16 * 16;
+    if (bulk != 0) {
+        HWY_DYNAMIC_DISPATCH(Aes128GcmCrypt)(in, bulk, key_->key().round_keys(), key_->htable(),
+                                             ctr_, ghash_, decrypt, out);
+        in += bulk;
+        out += bulk;
+        len -= bulk;
+    }
+    if (len != 0) {
+        memset(keystream_, 0, 16);
+        HWY_DYNAMIC_DISPATCH(Aes128GcmCrypt)((const char*)keystream_, 16,
+                                             key_->key().round_keys(), key_->htable(), ctr_,
+                                             nullptr, false, (char*)keystream_);
+        xor_keystream(len);
+    }
+}
+
+void aes128_gcm_stream::compute_tag(uint8_t* tag) {
+    hash_pending();
+    uint8_t lengths[16];
+    store_be64(lengths, aad_size_ * 8);
+    store_be64(lengths + 8, text_size_ * 8);
+    HWY_DYNAMIC_DISPATCH(Aes128GcmHash)((const char*)lengths, 16, key_->htable(), ghash_);
+
+    uint8_t j0[16], mask[16] = {0};
+    memcpy(j0, j0_, 16);
+    HWY_DYNAMIC_DISPATCH(Aes128GcmCrypt)((const char*)mask, 16, key_->key().round_keys(),
+                                         key_->htable(), j0, nullptr, false, (char*)mask);
+    for (int i = 0; i < 16; ++i) {
+        tag[i] = mask[i] ^ ghash_[15 - i];
+    }
+}
+
+size_t aes128_gcm_sealer::update(const char* in, size_t len, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + len);
+    update(in, len, &out[pos]);
+    return len;
+}
+
+size_t aes128_gcm_sealer::final(char* tag, size_t cap) {
+    if (HWY_UNLIKELY(cap < aes128_gcm_tag_size)) {
+        throw std::length_error("Output buffer too small");
+    }
+    compute_tag((uint8_t*)tag);
+    return aes128_gcm_tag_size;
+}
+
+size_t aes128_gcm_sealer::final(std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + aes128_gcm_tag_size);
+    compute_tag((uint8_t*)&out[pos]);
+    return aes128_gcm_tag_size;
+}
+
+size_t aes128_gcm_opener::update(const char* in, size_t len, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + len);
+    update(in, len, &out[pos]);
+    return len;
+}
+
+void aes128_gcm_opener::final(const char* tag, size_t tag_size) {
+    uint8_t expected[16];
+    compute_tag(expected);
+    // Constant time, and never accept a truncated tag.
+    uint8_t diff = tag_size != aes128_gcm_tag_size;
+    for (size_t i = 0; i < 16 && i < tag_size; ++i) {
+        diff |= expected[i] ^ (uint8_t)tag[i];
+    }
+    if (HWY_UNLIKELY(diff != 0)) {
+        throw std::runtime_error("Invalid aes128-gcm tag");
+    }
+}
+
+size_t aes128_gcm_seal(const aes128_gcm_key& key, const char* iv, size_t iv_size,
+                       const char* aad, size_t aad_size, const char* plain, size_t plain_size,
+                       char* out, size_t cap) {
+    const size_t n = aes128_gcm_seal_size(plain, plain_size);
+    if (HWY_UNLIKELY(cap < n)) {
+        throw std::length_error("Output buffer too small");
+    }
+    aes128_gcm_sealer sealer(key, iv, iv_size);
+    sealer.aad(aad, aad_size);
+    sealer.update(plain, plain_size, out);
+    sealer.final(out + plain_size, aes128_gcm_tag_size);
+    return n;
+}
+
+size_t aes128_gcm_open(const aes128_gcm_key& key, const char* iv, size_t iv_size,
+                       const char* aad, size_t aad_size, const char* cipher, size_t cipher_size,
+                       char* out, size_t cap) {
+    if (HWY_UNLIKELY(cipher_size < aes128_gcm_tag_size)) {
+        throw std::runtime_error("Invalid aes128-gcm size");
+    }
+    const size_t n = aes128_gcm_open_size(cipher, cipher_size);
+    if (HWY_UNLIKELY(cap < n)) {
+        throw std::length_error("Output buffer too small");
+    }
+    aes128_gcm_opener opener(key, iv, iv_size);
+    opener.aad(aad, aad_size);
+    opener.update(cipher, n, out);
+    try {
+        opener.final(cipher + n, aes128_gcm_tag_size);
+    } catch (...) {
+        memset(out, 0, n);
+        throw;
+    }
+    return n;
+}
+
+size_t aes128_gcm_seal(const aes128_gcm_key& key, const char* iv, size_t iv_size,
+                       const char* aad, size_t aad_size, const char* plain, size_t plain_size,
+                       std::string& out) {
+    // The sealer checks the IV before `out` grows, nothing throws after that.
+    aes128_gcm_sealer sealer(key, iv, iv_size);
+    sealer.aad(aad, aad_size);
+    const size_t pos = out.size();
+    const size_t n   = aes128_gcm_seal_size(plain, plain_size);
+    out.resize(pos + n);
+    sealer.update(plain, plain_size, &out[pos]);
+    sealer.final(&out[pos + plain_size], aes128_gcm_tag_size);
+    return n;
+}
+
+size_t aes128_gcm_open(const aes128_gcm_key& key, const char* iv, size_t iv_size,
+                       const char* aad, size_t aad_size, const char* cipher, size_t cipher_size,
+                       std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + aes128_gcm_open_size(cipher, cipher_size));
+    try {
+        return aes128_gcm_open(key, iv, iv_size, aad, aad_size, cipher, cipher_size, &out[pos],
+                               out.size() - pos);
+    } catch (...) {
+        out.resize(pos);
+        throw;
+    }
 }
 
 }  // namespace ss
+
+#endif  // HWY_ONCE
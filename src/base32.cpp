@@ -0,0 +1,455 @@
+#include "strings/base32.h"
+#include <stdexcept>
+#include <string>
+#include <string.h>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "src/base32.cpp"
+#include <hwy/foreach_target.h>  // IWYU pragma: keep
+
+#include "detail/hwy.h"
+#include <hwy/contrib/unroller/unroller-inl.h>
+
+HWY_BEFORE_NAMESPACE();
+namespace ss {
+namespace HWY_NAMESPACE {
+
+namespace {
+
+using D = hn::ScalableTag<u8>;
+
+static constexpr HWY_FULL(uint64_t) _du64{};
+using vu64 = hn::Vec<HWY_FULL(uint64_t)>;
+
+// Both alphabets are a run of letters and a run of digits, so characters and
+// 5-bit values convert with a compare and an add.
+struct Alphabet {
+    // encode: value + (value < split ? below : above)
+    vu8 _split, _below, _above;
+    // decode: digits from `digit` map to `digit_value` on, letters of either
+    // case from 'a' to `letter_value` on
+    vu8 _digit, _digits, _digit_value, _letters, _letter_value;
+    const vu8 _0x20 = hn::Set(_du8, 0x20);
+    const vu8 _a    = hn::Set(_du8, 'a');
+
+    Alphabet(const ss::base32_options& opts) {
+        const char letter = opts.lower ? 'a' : 'A';
+        if (opts.alphabet == ss::base32_alphabet::hex) {
+            _split        = hn::Set(_du8, 10);
+            _below        = hn::Set(_du8, '0');
+            _above        = hn::Set(_du8, (u8)(letter - 10));
+            _digit        = hn::Set(_du8, '0');
+            _digits       = hn::Set(_du8, 10);
+            _digit_value  = hn::Set(_du8, 0);
+            _letters      = hn::Set(_du8, 22);
+            _letter_value = hn::Set(_du8, 10);
+        } else {
+            _split        = hn::Set(_du8, 26);
+            _below        = hn::Set(_du8, (u8)letter);
+            _above        = hn::Set(_du8, '2' - 26);
+            _digit        = hn::Set(_du8, '2');
+            _digits       = hn::Set(_du8, 6);
+            _digit_value  = hn::Set(_du8, 26);
+            _letters      = hn::Set(_du8, 26);
+            _letter_value = hn::Set(_du8, 0);
+        }
+    }
+
+    // 5-bit values to characters.
+    vu8 Encode(const vu8 values) const {
+        return hn::Add(values, hn::IfThenElse(hn::Lt(values, _split), _below, _above));
+    }
+
+    // Characters to 5-bit values, 0 in the lanes set in `outside`.
+    vu8 Decode(const vu8 xx, hn::Mask<D>& outside) const {
+        const auto digit    = hn::Sub(xx, _digit);
+        const auto letter   = hn::Sub(hn::Or(xx, _0x20), _a);
+        const auto is_digit = hn::Lt(digit, _digits);
+        const auto value    = hn::IfThenElse(is_digit, hn::Add(digit, _digit_value),
+                                             hn::Add(letter, _letter_value));
+        outside = hn::Not(hn::Or(is_digit, hn::Lt(letter, _letters)));
+        return hn::IfThenZeroElse(outside, value);
+    }
+};
+
+// 5 input bytes per 8 chars, 2 groups per 128-bit block. Each u16 lane gets
+// the two bytes holding its pair of chars, which multiplies shift into place.
+struct EncodeUnit : hn::UnrollerUnit<EncodeUnit, u8, u8> {
+    const vu16 _0x001f = hn::Set(_du16, 0x001f);
+    const vu16 _0x1f00 = hn::Set(_du16, 0x1f00);
+    // the pair of lane m sits 2m bits down from the top of its u16
+    const vu16 _mul_hi = hn::Dup128VecFromValues(_du16, 32, 128, 512, 2048, 32, 128, 512, 2048);
+    const vu16 _mul_lo = hn::Dup128VecFromValues(_du16, 4, 16, 64, 256, 4, 16, 64, 256);
+    const vu8 _0       = hn::Set(_du8, 0);
+
+    static constexpr size_t kMultiple = N8 / 16;
+    static constexpr size_t kIn       = N8 / 8 * 5;  // input bytes per vector of output
+    // LoadAt(p) reads [p - kBehind, p - 6 + N8)
+    static constexpr size_t kBehind = kMultiple == 4 ? 18 : 6;
+
+    // clang-format off
+    // the 10 bytes of a block start at lane 6 of even blocks, lane 0 of odd ones
+    HWY_ALIGN static constexpr uint8_t _shuf_buf[] = {
+        7, 6, 8, 7, 9, 8, 10, 9, 12, 11, 13, 12, 14, 13, 15, 14,  //
+        1, 0, 2, 1, 3, 2, 4,  3, 6,  5,  7,  6,  8,  7,  9,  8,   //
+        7, 6, 8, 7, 9, 8, 10, 9, 12, 11, 13, 12, 14, 13, 15, 14,  //
+        1, 0, 2, 1, 3, 2, 4,  3, 6,  5,  7,  6,  8,  7,  9,  8,   //
+    };
+    const vu8 _shuffle = hn::LoadU(_du8, _shuf_buf);
+    // clang-format on
+
+    const Alphabet& _alphabet;
+    EncodeUnit(const Alphabet& alphabet) : _alphabet(alphabet) {}
+
+    hn::Vec<D> Func(ptrdiff_t, const hn::Vec<D> xx, const hn::Vec<D>) {
+        const auto in     = hn::BitCast(_du16, hn::TableLookupBytes(xx, _shuffle));
+        const auto first  = hn::And(hn::MulHigh(in, _mul_hi), _0x001f);
+        const auto second = hn::And(hn::Mul(in, _mul_lo), _0x1f00);
+        return _alphabet.Encode(hn::BitCast(_du8, hn::Or(first, second)));
+    }
+
+    // The kIn input bytes at `p`, placed for the shuffle.
+    hn::Vec<D> LoadAt(const u8* p) {
+        if constexpr (kMultiple == 4) {
+            // blocks 0 and 1 from src[j - 6, j + 26), 2 and 3 from src[j + 14, j + 46)
+            auto lo = hn::LoadU(_du8, p - 6);
+            auto hi = hn::LoadU(_du8, p - 18);
+            return hn::ConcatUpperLower(_du8, hi, lo);
+        } else {
+            return hn::LoadU(_du8, p - 6);
+        }
+    }
+
+    hn::Vec<D> LoadImpl(const ptrdiff_t idx, const u8* from) {
+        /// indexof(src):indexof(dest) => 5:8
+        return LoadAt(from + idx * 5 / 8);
+    }
+
+    // At most a vector of output from the `n` bytes at `from`, loaded from a
+    // stack block so that LoadAt stays in bounds at both ends of the input.
+    void Block(const u8* from, size_t n, u8* to, size_t count) {
+        HWY_ALIGN u8 block[kBehind + N8] = {0};
+        memcpy(block + kBehind, from, n);
+        hn::StoreN(Func(0, LoadAt(block + kBehind), _0), _du8, to, count);
+    }
+};
+
+// Unpadded output of `len` bytes.
+size_t EncodeBody(const Alphabet& alphabet, const u8* in, size_t len, u8* out) {
+    EncodeUnit unit(alphabet);
+    const size_t olen = (len * 8 + 4) / 5;
+    if (olen == 0) {
+        return 0;
+    }
+    // the first vector has nothing to look behind, the middle ones are
+    // those whose loads end inside the input
+    unit.Block(in, HWY_MIN(len, EncodeUnit::kIn), out, HWY_MIN(olen, N8));
+    size_t i = EncodeUnit::kIn;
+    size_t o = N8;
+    if (len + 6 >= N8 + EncodeUnit::kIn) {
+        const size_t vectors = (len + 6 - N8) / EncodeUnit::kIn;
+        hn::Unroller(unit, const_cast<u8*>(in) + i, out + o, vectors * N8);
+        i += vectors * EncodeUnit::kIn;
+        o += vectors * N8;
+    }
+    for (; o < olen; i += EncodeUnit::kIn, o += N8) {
+        unit.Block(in + i, HWY_MIN(len - i, EncodeUnit::kIn), out + o, HWY_MIN(olen - o, N8));
+    }
+    return olen;
+}
+
+template <bool kWrite>
+struct DecodeUnit : hn::UnrollerUnit<DecodeUnit<kWrite>, u8, u8> {
+    const hn::Vec<D> _0x0120     = hn::BitCast(_du8, hn::Set(_du16, 0x0120));
+    const hn::Vec<D> _0x00010400 = hn::BitCast(_du8, hn::Set(_du32, 0x00010400));
+    const vu64 _0xfffff          = hn::Set(_du64, 0xfffff);
+    // clang-format off
+    HWY_ALIGN static constexpr uint8_t _pack_buf[] = {
+        4,  3,  2,  1,  0,  12, 11, 10, 9,  8,  0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  //
+        4,  3,  2,  1,  0,  12, 11, 10, 9,  8,  0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  //
+        4,  3,  2,  1,  0,  12, 11, 10, 9,  8,  0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  //
+        4,  3,  2,  1,  0,  12, 11, 10, 9,  8,  0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  //
+    };
+    const hn::Vec<D> _pack = hn::LoadU(_du8, _pack_buf);
+    // clang-format on
+
+    const Alphabet& _alphabet;
+    ptrdiff_t _places = N8;  // valid lanes of the block being decoded
+    vu8 _bad          = hn::Zero(_du8);  // invalid lanes of every block, or-ed together
+    DecodeUnit(const Alphabet& alphabet) : _alphabet(alphabet) {}
+
+    hn::Vec<D> Func(ptrdiff_t, const hn::Vec<D> xx, const hn::Vec<D> yy) {
+        /// lookup, the first bad lane is only looked for after the loop
+        hn::Mask<D> outside;
+        const auto values = _alphabet.Decode(xx, outside);
+        auto bad          = hn::VecFromMask(_du8, outside);
+        if (HWY_UNLIKELY(_places < (ptrdiff_t)N8)) {
+            bad = hn::IfThenElseZero(hn::FirstN(_du8, _places), bad);
+        }
+        _bad = hn::Or(_bad, bad);
+        if constexpr (!kWrite) {
+            return hn::Zero(_du8);
+        }
+
+        /// 8 x 5 bits -> 4 x 10 -> 2 x 20 -> 40 bits, then the 5 bytes of each
+        /// group in order
+        const auto pairs = hn::SatWidenMulPairwiseAdd(_di16, values, hn::BitCast(_di8, _0x0120));
+        const auto quads = hn::WidenMulPairwiseAdd(_du32, hn::BitCast(_du16, pairs),
+                                                   hn::BitCast(_du16, _0x00010400));
+        const auto halves = hn::BitCast(_du64, quads);
+        const auto group  = hn::Or(hn::ShiftLeft<20>(hn::And(halves, _0xfffff)),
+                                   hn::ShiftRight<32>(halves));
+        return hn::TableLookupBytes(hn::BitCast(_du8, group), _pack);
+    }
+
+    hn::Vec<D> MaskLoad(const ptrdiff_t idx, u8* from, const ptrdiff_t places) {
+        ptrdiff_t i = idx;
+        ptrdiff_t p = places;
+        if (places < 0) {
+            i = idx + places + N8;
+            p = -places;
+        }
+        _places = p;
+        return this->me()->MaskLoadImpl(i, from, p);
+    }
+
+    bool StoreAndShortCircuitImpl(const ptrdiff_t idx, uint8_t* to, const hn::Vec<D> x) {
+        if constexpr (!kWrite) {
+            return true;
+        }
+        /// indexof(src):indexof(dest) => 8:5
+        ptrdiff_t j                = idx * 5 / 8;
+        constexpr size_t count     = 10;  // 16 * 5 / 8
+        constexpr size_t multiples = N8 / 16;
+        HWY_ALIGN uint8_t buf[64]  = {0};
+        hn::StoreU(x, _du8, buf);
+        for (int i = 0; i < multiples; ++i, j += count) {
+            hwy::CopyBytes(buf + i * 16, to + j, count);
+        }
+        return true;
+    }
+
+    ptrdiff_t
+    MaskStoreImpl(const ptrdiff_t idx, u8* to, const hn::Vec<D> x, const ptrdiff_t places) {
+        if constexpr (!kWrite) {
+            return 0;
+        }
+        /// convert neg places
+        ptrdiff_t i = idx;
+        ptrdiff_t p = places;
+        if (places < 0) {
+            i = idx + places + N8;
+            p = -places;
+        }
+
+        ptrdiff_t j                = i * 5 / 8;
+        constexpr size_t count     = 10;  // 16 * 5 / 8
+        constexpr size_t multiples = N8 / 16;
+        // 8:5, and a final group of 2, 4, 5 or 7 chars holds 1 to 4 bytes
+        int left = p / 8 * 5 + p % 8 * 5 / 8;
+
+        const size_t z            = left;
+        HWY_ALIGN uint8_t buf[64] = {0};
+        hn::StoreU(x, _du8, buf);
+        for (int i = 0; i < multiples && left > 0; ++i, j += count, left -= count) {
+            hwy::CopyBytes(buf + i * 16, to + j, HWY_MIN(left, count));
+        }
+        return z;
+    }
+
+    // Only on the error path: where the first bad byte is.
+    size_t FirstBad(const u8* from, size_t len) const {
+        for (size_t i = 0; i < len; i += N8) {
+            const size_t n = HWY_MIN(N8, len - i);
+            hn::Mask<D> outside;
+            _alphabet.Decode(hn::LoadN(_du8, from + i, n), outside);
+            const intptr_t j = hn::FindFirstTrue(_du8, hn::And(outside, hn::FirstN(_du8, n)));
+            if (j >= 0) {
+                return i + j;
+            }
+        }
+        return len;
+    }
+};
+
+template <bool kWrite>
+ss::decode_result DecodeBody(const char* in, size_t len, const ss::base32_options& opts,
+                             char* out) {
+    size_t padding = 0;
+    for (; padding < len && in[len - 1 - padding] == '='; ++padding)
+        ;
+    if (HWY_UNLIKELY(padding > 6)) {
+        return {0, len - padding, ss::decode_error::invalid_padding};
+    }
+    // padded input comes in whole groups, and a group cannot end after 1, 3 or 6 chars
+    const size_t n   = len - padding;
+    const size_t rem = n % 8;
+    if (HWY_UNLIKELY(padding > 0 && len % 8 != 0)) {
+        return {0, len, ss::decode_error::invalid_length};
+    }
+    if (HWY_UNLIKELY(rem == 1 || rem == 3 || rem == 6)) {
+        return padding > 0 ? ss::decode_result{0, n, ss::decode_error::invalid_padding}
+                           : ss::decode_result{0, len, ss::decode_error::invalid_length};
+    }
+    const Alphabet alphabet(opts);
+    DecodeUnit<kWrite> unit(alphabet);
+    hn::Unroller(unit, (u8*)(const_cast<char*>(in)), (u8*)out, n);
+    if (HWY_UNLIKELY(!hn::AllFalse(_du8, hn::MaskFromVec(unit._bad)))) {
+        const size_t ofs = unit.FirstBad((const u8*)in, n);
+        return {0, ofs,
+                in[ofs] == '=' ? ss::decode_error::invalid_padding
+                               : ss::decode_error::invalid_byte};
+    }
+    return {n / 8 * 5 + rem * 5 / 8, 0, ss::decode_error::none};
+}
+
+}  // namespace
+
+size_t Base32Encode(const char* in, size_t len, const ss::base32_options& opts, char* out) {
+    const Alphabet alphabet(opts);
+    size_t olen = EncodeBody(alphabet, (const u8*)in, len, (u8*)out);
+    if (opts.padding) {
+        for (; olen % 8 != 0; ++olen) {
+            out[olen] = '=';
+        }
+    }
+    return olen;
+}
+
+ss::decode_result
+Base32Decode(const char* in, size_t len, const ss::base32_options& opts, char* out) {
+    return DecodeBody<true>(in, len, opts, out);
+}
+
+ss::decode_result Base32Validate(const char* in, size_t len, const ss::base32_options& opts) {
+    return DecodeBody<false>(in, len, opts, nullptr);
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+
+namespace ss {
+
+HWY_EXPORT(Base32Encode);
+HWY_EXPORT(Base32Decode);
+HWY_EXPORT(Base32Validate);
+
+namespace {
+
+// What the throwing decoders raise for a failed `r`.
+[[noreturn]] void throw_base32_error(const decode_result& r, const char* in) {
+    switch (r.error) {
+    case decode_error::invalid_length: throw std::runtime_error("Invalid base32 text size");
+    case decode_error::output_too_small: throw std::length_error("Output buffer too small");
+    default: throw input_error(r.offset, in[r.offset]);
+    }
+}
+
+}  // namespace
+
+size_t base32_encode(const char* in, size_t len, const base32_options& opts, char* out,
+                     size_t cap) {
+    if (HWY_UNLIKELY(cap < base32_encode_size(in, len, opts))) {
+        throw std::length_error("Output buffer too small");
+    }
+    return HWY_DYNAMIC_DISPATCH(Base32Encode)(in, len, opts, out);
+}
+
+size_t base32_encode(const char* in, size_t len, const base32_options& opts, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + base32_encode_size(in, len, opts));
+    return HWY_DYNAMIC_DISPATCH(Base32Encode)(in, len, opts, &out[pos]);
+}
+
+decode_result try_base32_decode(const char* in, size_t len, const base32_options& opts,
+                                char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < base32_decode_size(in, len))) {
+        return {0, 0, decode_error::output_too_small};
+    }
+    return HWY_DYNAMIC_DISPATCH(Base32Decode)(in, len, opts, out);
+}
+
+decode_result try_base32_decode(const char* in, size_t len, const base32_options& opts,
+                                std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + base32_decode_size(in, len));
+    const auto r = HWY_DYNAMIC_DISPATCH(Base32Decode)(in, len, opts, &out[pos]);
+    out.resize(pos + r.size);
+    return r;
+}
+
+decode_result base32_validate(const char* in, size_t len, const base32_options& opts) {
+    return HWY_DYNAMIC_DISPATCH(Base32Validate)(in, len, opts);
+}
+
+size_t base32_decode(const char* in, size_t len, const base32_options& opts, char* out,
+                     size_t cap) {
+    const auto r = try_base32_decode(in, len, opts, out, cap);
+    if (HWY_UNLIKELY(!r)) {
+        throw_base32_error(r, in);
+    }
+    return r.size;
+}
+
+size_t base32_decode(const char* in, size_t len, const base32_options& opts, std::string& out) {
+    const auto r = try_base32_decode(in, len, opts, out);
+    if (HWY_UNLIKELY(!r)) {
+        throw_base32_error(r, in);
+    }
+    return r.size;
+}
+
+std::string base32_encode(const char* in, size_t len, const base32_options& opts) {
+    std::string result;
+    base32_encode(in, len, opts, result);
+    return result;
+}
+
+std::string base32_decode(const char* in, size_t len, const base32_options& opts) {
+    std::string result;
+    base32_decode(in, len, opts, result);
+    return result;
+}
+
+size_t base32_encode(const char* in, size_t len, char* out, size_t cap) {
+    return base32_encode(in, len, base32_options{}, out, cap);
+}
+
+size_t base32_encode(const char* in, size_t len, std::string& out) {
+    return base32_encode(in, len, base32_options{}, out);
+}
+
+decode_result try_base32_decode(const char* in, size_t len, char* out, size_t cap) {
+    return try_base32_decode(in, len, base32_options{}, out, cap);
+}
+
+decode_result try_base32_decode(const char* in, size_t len, std::string& out) {
+    return try_base32_decode(in, len, base32_options{}, out);
+}
+
+decode_result base32_validate(const char* in, size_t len) {
+    return base32_validate(in, len, base32_options{});
+}
+
+size_t base32_decode(const char* in, size_t len, char* out, size_t cap) {
+    return base32_decode(in, len, base32_options{}, out, cap);
+}
+
+size_t base32_decode(const char* in, size_t len, std::string& out) {
+    return base32_decode(in, len, base32_options{}, out);
+}
+
+std::string base32_encode(const char* in, size_t len) {
+    return base32_encode(in, len, base32_options{});
+}
+
+std::string base32_decode(const char* in, size_t len) {
+    return base32_decode(in, len, base32_options{});
+}
+
+}  // namespace ss
+
+#endif  // HWY_ONCE
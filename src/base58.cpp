@@ -0,0 +1,216 @@
+#include "strings/base58.h"
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace ss {
+
+namespace {
+
+constexpr char kDigits[]   = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+constexpr uint32_t kPow[]  = {1, 58, 3364, 195112, 11316496, 656356768};
+constexpr uint32_t kLimb   = kPow[5];  // 5 digits
+constexpr size_t kOnStack  = 64;       // limbs, enough for 230-byte values
+
+struct digit_values {
+    int8_t v[256];
+    constexpr digit_values() : v() {
+        for (auto& x : v) {
+            x = -1;
+        }
+        for (int i = 0; i < 58; ++i) {
+            v[(uint8_t)kDigits[i]] = (int8_t)i;
+        }
+    }
+};
+constexpr digit_values kValues;
+
+// Little-endian limbs, on the stack for the short ids base58 is used for.
+class limbs {
+    uint32_t small_[kOnStack];
+    std::vector<uint32_t> big_;
+    uint32_t* p_ = small_;
+    size_t n_    = 0;
+
+public:
+    explicit limbs(size_t cap) {
+        if (cap > kOnStack) {
+            big_.resize(cap);
+            p_ = big_.data();
+        }
+    }
+
+    size_t size() const { return n_; }
+    uint32_t operator[](size_t i) const { return p_[i]; }
+
+    // this = this * mul + add, in limbs of base Radix
+    template <uint64_t Radix>
+    void mul_add(uint64_t mul, uint64_t add) {
+        uint64_t carry = add;
+        for (size_t i = 0; i < n_; ++i) {
+            const uint64_t t = p_[i] * mul + carry;
+            p_[i]            = (uint32_t)(t % Radix);
+            carry            = t / Radix;
+        }
+        for (; carry > 0; carry /= Radix) {
+            p_[n_++] = (uint32_t)(carry % Radix);
+        }
+    }
+};
+
+size_t encode(const uint8_t* in, size_t len, char* out) {
+    size_t zeros = 0;
+    for (; zeros < len && in[zeros] == 0; ++zeros)
+        ;
+    in += zeros;
+    len -= zeros;
+
+    // a 5-digit limb holds over 29 bits: absorb big-endian 32-bit words, the
+    // first one short when len is not a multiple of 4
+    limbs x(len * 8 / 29 + 2);
+    const size_t head = len % 4;
+    if (head > 0) {
+        uint32_t w = 0;
+        for (size_t i = 0; i < head; ++i) {
+            w = w << 8 | in[i];
+        }
+        x.mul_add<kLimb>(1ull << (head * 8), w);
+    }
+    for (size_t i = head; i < len; i += 4) {
+        const uint32_t w = (uint32_t)in[i] << 24 | (uint32_t)in[i + 1] << 16
+                           | (uint32_t)in[i + 2] << 8 | in[i + 3];
+        x.mul_add<kLimb>(1ull << 32, w);
+    }
+
+    memset(out, '1', zeros);
+    char* p = out + zeros;
+    if (x.size() == 0) {
+        return zeros;
+    }
+    // the top limb without its leading zero digits, then 5 digits per limb
+    char top[5];
+    size_t k = 0;
+    for (uint32_t v = x[x.size() - 1]; v > 0; v /= 58) {
+        top[k++] = kDigits[v % 58];
+    }
+    while (k > 0) {
+        *p++ = top[--k];
+    }
+    for (size_t i = x.size() - 1; i-- > 0;) {
+        uint32_t v = x[i];
+        for (int j = 4; j >= 0; --j, v /= 58) {
+            p[j] = kDigits[v % 58];
+        }
+        p += 5;
+    }
+    return p - out;
+}
+
+decode_result decode(const char* in, size_t len, char* out) {
+    size_t ones = 0;
+    for (; ones < len && in[ones] == '1'; ++ones)
+        ;
+
+    // 58^m needs about m * 5.86 bits: absorb 5 digits at a time, the first
+    // group short when there are not a multiple of 5
+    const size_t m = len - ones;
+    limbs x(m / 5 + 2);
+    for (size_t i = ones, group = m % 5 ? m % 5 : 5; i < len; i += group, group = 5) {
+        uint32_t v = 0;
+        for (size_t j = i; j < i + group; ++j) {
+            const int d = kValues.v[(uint8_t)in[j]];
+            if (d < 0) {
+                return {0, j, decode_error::invalid_byte};
+            }
+            v = v * 58 + d;
+        }
+        x.mul_add<1ull << 32>(kPow[group], v);
+    }
+
+    memset(out, 0, ones);
+    char* p = out + ones;
+    if (x.size() == 0) {
+        return {ones, 0, decode_error::none};
+    }
+    const uint32_t top = x[x.size() - 1];
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        if ((top >> shift) != 0) {
+            *p++ = (char)(top >> shift);
+        }
+    }
+    for (size_t i = x.size() - 1; i-- > 0;) {
+        const uint32_t v = x[i];
+        p[0]             = (char)(v >> 24);
+        p[1]             = (char)(v >> 16);
+        p[2]             = (char)(v >> 8);
+        p[3]             = (char)v;
+        p += 4;
+    }
+    return {(size_t)(p - out), 0, decode_error::none};
+}
+
+}  // namespace
+
+size_t base58_encode(const char* in, size_t len, char* out, size_t cap) {
+    if (cap < base58_encode_size(in, len)) {
+        throw std::length_error("Output buffer too small");
+    }
+    return encode((const uint8_t*)in, len, out);
+}
+
+size_t base58_encode(const char* in, size_t len, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + base58_encode_size(in, len));
+    const size_t n = encode((const uint8_t*)in, len, &out[pos]);
+    out.resize(pos + n);
+    return n;
+}
+
+decode_result try_base58_decode(const char* in, size_t len, char* out, size_t cap) {
+    if (cap < base58_decode_size(in, len)) {
+        return {0, 0, decode_error::output_too_small};
+    }
+    return decode(in, len, out);
+}
+
+decode_result try_base58_decode(const char* in, size_t len, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + base58_decode_size(in, len));
+    const auto r = decode(in, len, &out[pos]);
+    out.resize(pos + r.size);
+    return r;
+}
+
+size_t base58_decode(const char* in, size_t len, char* out, size_t cap) {
+    const auto r = try_base58_decode(in, len, out, cap);
+    if (!r) {
+        if (r.error == decode_error::output_too_small) {
+            throw std::length_error("Output buffer too small");
+        }
+        throw input_error(r.offset, in[r.offset]);
+    }
+    return r.size;
+}
+
+size_t base58_decode(const char* in, size_t len, std::string& out) {
+    const auto r = try_base58_decode(in, len, out);
+    if (!r) {
+        throw input_error(r.offset, in[r.offset]);
+    }
+    return r.size;
+}
+
+std::string base58_encode(const char* in, size_t len) {
+    std::string result;
+    base58_encode(in, len, result);
+    return result;
+}
+
+std::string base58_decode(const char* in, size_t len) {
+    std::string result;
+    base58_decode(in, len, result);
+    return result;
+}
+
+}  // namespace ss
@@ -1,10 +1,19 @@
 #include "strings/base64.h"
-#include "detail/hwy.h"
 #include <stdexcept>
 #include <string>
-#include <hwy/contrib/unroller/unroller-inl.h>
 #include <string.h>
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "src/base64.cpp"
+#include <hwy/foreach_target.h>  // IWYU pragma: keep
+
+#include "detail/hwy.h"
+#include <hwy/contrib/unroller/unroller-inl.h>
+
+HWY_BEFORE_NAMESPACE();
+namespace ss {
+namespace HWY_NAMESPACE {
+
 namespace {
 
 static inline size_t base64_padding_count(const char* buf, size_t len) {
@@ -14,31 +23,156 @@ static inline size_t base64_padding_count(const char* buf, size_t len) {
     return padding;
 }
 
-struct EncodeUnit : hn::UnrollerUnit<EncodeUnit, u8, u8> {
-    using D                = hn::ScalableTag<u8>;
+using D = hn::ScalableTag<u8>;
+
+// A-Z a-z 0-9 followed by kC62 and kC63: letters and digits are mapped by
+// high-nibble ranges, the two extra characters by compares.
+template <char kC62, char kC63>
+struct RangeAlphabet {
+    const vu8 _13  = hn::Set(_du8, 13);
+    const vu8 _26  = hn::Set(_du8, 26);
+    const vu8 _51  = hn::Set(_du8, 51);
+    const vu8 _62  = hn::Set(_du8, 62);
+    const vu8 _63  = hn::Set(_du8, 63);
+    const vu8 _c62 = hn::Set(_du8, (u8)kC62);
+    const vu8 _c63 = hn::Set(_du8, (u8)kC63);
+
+    // clang-format off
+    const vu8 _encode_lut =
+        hn::Dup128VecFromValues(_du8, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, kC62 - 62,
+                                kC63 - 63, 'A', 0, 0);
+    const vu8 _shift_lut = hn::Dup128VecFromValues(_du8,
+        /* 0 */ 0x00,        /* 1 */ 0x00,        /* 2 */ 0x00,        /* 3 */ 0x34 - 0x30,
+        /* 4 */ 0x00 - 0x41, /* 5 */ 0x0f - 0x50, /* 6 */ 0x1a - 0x61, /* 7 */ 0x29 - 0x70,
+        /* 8 */ 0x00,        /* 9 */ 0x00,        /* a */ 0x00,        /* b */ 0x00,
+        /* c */ 0x00,        /* d */ 0x00,        /* e */ 0x00,        /* f */ 0x00
+    );
+
+    enum { hinv = 0, linv = 1 };
+    const vu8 _lower_lut = hn::Dup128VecFromValues(_du8,
+        /* 0 */ linv, /* 1 */ linv, /* 2 */ linv, /* 3 */ 0x30,
+        /* 4 */ 0x41, /* 5 */ 0x50, /* 6 */ 0x61, /* 7 */ 0x70,
+        /* 8 */ linv, /* 9 */ linv, /* a */ linv, /* b */ linv,
+        /* c */ linv, /* d */ linv, /* e */ linv, /* f */ linv
+    );
+    const vu8 _upper_lut = hn::Dup128VecFromValues(_du8,
+        /* 0 */ hinv, /* 1 */ hinv, /* 2 */ hinv, /* 3 */ 0x39,
+        /* 4 */ 0x4f, /* 5 */ 0x5a, /* 6 */ 0x6f, /* 7 */ 0x7a,
+        /* 8 */ hinv, /* 9 */ hinv, /* a */ hinv, /* b */ hinv,
+        /* c */ hinv, /* d */ hinv, /* e */ hinv, /* f */ hinv
+    );
+    // clang-format on
+
+    // 6-bit indices to characters.
+    vu8 Encode(const vu8 indices) const {
+        // refer:
+        // https://github.com/WojciechMula/base64simd/blob/master/encode/lookup.sse.cpp
+        auto result     = hn::SaturatedSub(indices, _51);
+        const auto less = IfThenElseZero(Lt(_du8, indices, _26), _13);
+        result          = hn::Or(result, less);
+        result          = hn::TableLookupBytes(_encode_lut, result);
+        return hn::Add(result, indices);
+    }
+
+    // Characters to 6-bit values; lanes outside the alphabet are set in `outside`.
+    vu8 Decode(const vu8 xx, hn::Mask<D>& outside) const {
+        // refer:
+        // https://github.com/WojciechMula/base64simd/blob/master/decode/lookup.sse.cpp
+        const auto higher_nibble = hn::ShiftRightSame(xx, 4);
+        const auto t0     = hn::Add(xx, hn::TableLookupBytes(_shift_lut, higher_nibble));
+        const auto below  = hn::Lt(xx, hn::TableLookupBytes(_lower_lut, higher_nibble));
+        const auto above  = hn::Gt(xx, hn::TableLookupBytes(_upper_lut, higher_nibble));
+        const auto eq_c62 = hn::Eq(xx, _c62);
+        const auto eq_c63 = hn::Eq(xx, _c63);
+        outside = hn::AndNot(hn::Or(eq_c62, eq_c63), hn::Or(below, above));
+        return hn::IfThenElse(eq_c62, _62, hn::IfThenElse(eq_c63, _63, t0));
+    }
+};
+
+using StandardAlphabet = RangeAlphabet<'+', '/'>;
+using UrlAlphabet      = RangeAlphabet<'-', '_'>;
+
+// Any other alphabet: 16-entry rows of the character and value tables,
+// selected by the high nibble.
+struct TableAlphabet {
+    const vu8 _0x0f = hn::Set(_du8, 0x0f);
+    const vu8 _0x3f = hn::Set(_du8, 0x3f);
+    const vu8 _0xff = hn::Set(_du8, 0xff);
+    vu8 _chars[4];
+    vu8 _values[8];
+
+    TableAlphabet(const ss::base64_alphabet& a) {
+        for (int k = 0; k < 4; ++k) {
+            _chars[k] = hn::LoadDup128(_du8, (const u8*)a.chars() + k * 16);
+        }
+        for (int k = 0; k < 8; ++k) {
+            _values[k] = hn::LoadDup128(_du8, a.values() + k * 16);
+        }
+    }
+
+    vu8 Encode(const vu8 indices) const {
+        const auto lo = hn::And(indices, _0x0f);
+        const auto hi = hn::ShiftRightSame(indices, 4);
+        auto result   = hn::TableLookupBytes(_chars[0], lo);
+        for (int k = 1; k < 4; ++k) {
+            const auto row = hn::TableLookupBytes(_chars[k], lo);
+            result         = hn::IfThenElse(hn::Eq(hi, hn::Set(_du8, k)), row, result);
+        }
+        return result;
+    }
+
+    vu8 Decode(const vu8 xx, hn::Mask<D>& outside) const {
+        const auto lo = hn::And(xx, _0x0f);
+        const auto hi = hn::ShiftRightSame(xx, 4);
+        auto result   = _0xff;  // and for bytes >= 0x80
+        for (int k = 0; k < 8; ++k) {
+            const auto row = hn::TableLookupBytes(_values[k], lo);
+            result         = hn::IfThenElse(hn::Eq(hi, hn::Set(_du8, k)), row, result);
+        }
+        outside = hn::Eq(result, _0xff);
+        // keep bad lanes to 6 bits so they cannot carry into their neighbours
+        return hn::And(result, _0x3f);
+    }
+};
+
+// Run `f` with the policy for `a`: the standard and URL-safe alphabets get
+// their compile-time specializations, anything else the table one.
+template <typename F>
+auto WithAlphabet(const ss::base64_alphabet& a, F&& f) {
+    switch (a.kind()) {
+    case ss::base64_alphabet::standard: return f(StandardAlphabet());
+    case ss::base64_alphabet::url: return f(UrlAlphabet());
+    default: return f(TableAlphabet(a));
+    }
+}
+
+template <class Alphabet>
+struct EncodeUnit : hn::UnrollerUnit<EncodeUnit<Alphabet>, u8, u8> {
     const vu8 _0x0fc0fc00  = hn::BitCast(_du8, hn::Set(_du32, 0x0fc0fc00));
     const vu16 _0x04000040 = hn::BitCast(_du16, hn::Set(_du32, 0x04000040));
     const vu8 _0x003f03f0  = hn::BitCast(_du8, hn::Set(_du32, 0x003f03f0));
     const vu16 _0x01000010 = hn::BitCast(_du16, hn::Set(_du32, 0x01000010));
     const vu8 _0           = hn::Set(_du8, 0);
-    const vu8 _13          = hn::Set(_du8, 13);
-    const vu8 _25          = hn::Set(_du8, 25);
-    const vu8 _51          = hn::Set(_du8, 51);
+
+    static constexpr size_t kMultiple = N8 / 16;
+    static constexpr size_t kIn       = N8 / 4 * 3;  // input bytes per vector of output
+    // LoadAt(p) reads [p - kBehind, p - 4 + N8)
+    static constexpr size_t kBehind = kMultiple == 4 ? 12 : 4;
 
     // clang-format off
     HWY_ALIGN static constexpr uint8_t _encode_shuf_buf[] = {
         5,  4,  6,  5,  8,  7,  9,  8,  11, 10, 12, 11, 14, 13, 15, 14,  //
         17, 16, 18, 17, 20, 19, 21, 20, 23, 22, 24, 23, 26, 25, 27, 26,  //
-        37, 36, 38, 37, 40, 39, 41, 40, 43, 42, 44, 33, 46, 45, 47, 46,  //
+        37, 36, 38, 37, 40, 39, 41, 40, 43, 42, 44, 43, 46, 45, 47, 46,  //
         49, 48, 50, 49, 52, 51, 53, 52, 55, 54, 56, 55, 58, 57, 59, 58,  //
     };
     const vu8 _encode_indices = hn::LoadU(_du8, _encode_shuf_buf);
-    const vu8 _encode_lut =
-        hn::Dup128VecFromValues(_du8, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
-                                '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
-                                '/' - 63, 'A', 0, 0);
     // clang-format on
 
+    const Alphabet _alphabet;
+    EncodeUnit(const Alphabet& alphabet) : _alphabet(alphabet) {}
+
     hn::Vec<D> Func(ptrdiff_t, const hn::Vec<D> xx, const hn::Vec<D>) {
         // refer:
         // https://github.com/WojciechMula/base64simd/blob/master/encode/encode.sse.cpp
@@ -48,61 +182,109 @@ struct EncodeUnit : hn::UnrollerUnit<EncodeUnit, u8, u8> {
         const auto t2      = hn::And(in, _0x003f03f0);
         const auto t3      = hn::Mul(hn::BitCast(_du16, t2), _0x01000010);
         const auto indices = hn::Or(hn::BitCast(_du8, t1), hn::BitCast(_du8, t3));
-
-        // refer:
-        // https://github.com/WojciechMula/base64simd/blob/master/encode/lookup.sse.cpp
-        auto result     = hn::SaturatedSub(indices, _51);
-        const auto less = IfThenElseZero(Lt(_du8, indices, hn::Set(_du8, 26)), hn::Set(_du8, 13));
-        // const auto less = IfThenElseZero(hn::VecFromMask(hn::Lt(indices, hn::Set(_du8, 26))), hn::Set(_du8, 13));
-        result = hn::Or(result, less);
-
-        result = hn::TableLookupBytes(_encode_lut, result);
-        return hn::Add(result, indices);
+        return _alphabet.Encode(indices);
     }
 
-    hn::Vec<D> LoadImpl(const ptrdiff_t idx, const u8* from) {
-        constexpr size_t multiple = N8 / 16;
-        constexpr size_t count    = N8 * 3 / 4;
-
-        /// indexof(src):indexof(dest) => 3:4
-        ptrdiff_t j = idx * 3 / 4;
-        if constexpr (multiple == 4) {
-            auto p1 = hn::LoadN(_du8, from + j - 4, count + 4);
-            auto p2 = hn::LoadN(_du8, from + j + count - 4, count + 4);
-            return hn::Add(p1, hn::SlideUpLanes(_du8, p2, 32));
-        } else if constexpr (multiple == 2 || multiple == 1) {
-            return hn::LoadU(_du8, from + j - 4);
+    // The kIn input bytes at `p`, placed for the shuffle.
+    hn::Vec<D> LoadAt(const u8* p) {
+        if constexpr (kMultiple == 4) {
+            // lower 256 bits hold src[j, j + 24) at lane 4, upper 256 bits hold
+            // src[j + 24, j + 48) at lane 36.
+            auto lo = hn::LoadU(_du8, p - 4);
+            auto hi = hn::LoadU(_du8, p - 12);
+            return hn::ConcatUpperLower(_du8, hi, lo);
+        } else if constexpr (kMultiple == 2 || kMultiple == 1) {
+            return hn::LoadU(_du8, p - 4);
         } else {
             throw std::runtime_error("Unsupported lanes!!! sizeof(lanes) = " + std::to_string(N8));
         }
     }
 
-    hn::Vec<D> MaskLoadImpl(const ptrdiff_t idx, const u8* from, const ptrdiff_t places) {
-        /// convert neg places
-        if (places < 0) {
-            return me()->LoadImpl(idx + places + N8, from);
+    hn::Vec<D> LoadImpl(const ptrdiff_t idx, const u8* from) {
+        /// indexof(src):indexof(dest) => 3:4
+        return LoadAt(from + idx * 3 / 4);
+    }
+
+    // At most a vector of output from the `n` bytes at `from`, loaded from a
+    // stack block so that LoadAt stays in bounds at both ends of the input.
+    void Block(const u8* from, size_t n, u8* to, size_t count) {
+        HWY_ALIGN u8 block[kBehind + N8] = {0};
+        memcpy(block + kBehind, from, n);
+        hn::StoreN(Func(0, LoadAt(block + kBehind), _0), _du8, to, count);
+    }
+};
+
+// Unpadded output of `len` bytes.
+template <class Alphabet>
+size_t EncodeBody(const Alphabet& alphabet, const u8* in, size_t len, u8* out) {
+    using Unit = EncodeUnit<Alphabet>;
+    Unit unit(alphabet);
+    const size_t olen = (len * 4 + 2) / 3;
+    if (olen == 0) {
+        return 0;
+    }
+    // the first vector has nothing to look behind, the middle ones are
+    // those whose loads end inside the input
+    unit.Block(in, HWY_MIN(len, Unit::kIn), out, HWY_MIN(olen, N8));
+    size_t i = Unit::kIn;
+    size_t o = N8;
+    if (len + 4 >= N8 + Unit::kIn) {
+        const size_t vectors = (len + 4 - N8) / Unit::kIn;
+        hn::Unroller(unit, const_cast<u8*>(in) + i, out + o, vectors * N8);
+        i += vectors * Unit::kIn;
+        o += vectors * N8;
+    }
+    for (; o < olen; i += Unit::kIn, o += N8) {
+        unit.Block(in + i, HWY_MIN(len - i, Unit::kIn), out + o, HWY_MIN(olen - o, N8));
+    }
+    return olen;
+}
+
+// Unpadded output of the `n` bytes at `base + from`. Loads may use any of the
+// `total` bytes at `base`, so only vectors at either end of the whole input
+// go through a stack block.
+template <class Alphabet>
+size_t EncodeRange(EncodeUnit<Alphabet>& unit, const u8* base, size_t total, size_t from,
+                   size_t n, u8* out) {
+    using Unit        = EncodeUnit<Alphabet>;
+    const size_t olen = (n * 4 + 2) / 3;
+    for (size_t i = from, o = 0; o < olen; i += Unit::kIn, o += N8) {
+        const size_t count = HWY_MIN(olen - o, N8);
+        if (i >= Unit::kBehind && i + N8 <= total + 4) {
+            const auto v = unit.Func(0, unit.LoadAt(base + i), unit._0);
+            if (count == N8) {
+                hn::StoreU(v, _du8, out + o);
+            } else {
+                hn::StoreN(v, _du8, out + o, count);
+            }
         } else {
-            return me()->LoadImpl(idx, from);
+            unit.Block(base + i, HWY_MIN(total - i, Unit::kIn), out + o, count);
         }
     }
+    return olen;
+}
 
-    ptrdiff_t
-    MaskStoreImpl(const ptrdiff_t idx, u8* to, const hn::Vec<D> x, const ptrdiff_t places) {
-        ptrdiff_t i = idx;
-        ptrdiff_t p = std::abs(places);
-        if (places < 0) {
-            i = idx + places + N8;
+// Lines of opts.wrap chars joined by opts.newline, each encoded straight into
+// place: a line holds whole groups, so its last vector may read into the next
+// line and only its stores are cut short.
+template <class Alphabet>
+size_t EncodeLines(const Alphabet& alphabet, const u8* in, size_t len,
+                   const ss::base64_options& opts, u8* out) {
+    EncodeUnit<Alphabet> unit(alphabet);
+    const size_t line = opts.wrap / 4 * 3;
+    size_t o          = 0;
+    for (size_t i = 0; i < len; i += line) {
+        if (i > 0) {
+            memcpy(out + o, opts.newline.data(), opts.newline.size());
+            o += opts.newline.size();
         }
-        hn::BlendedStore(x, hn::FirstN(_du8, p), _du8, to + i);
-        return p;
+        o += EncodeRange(unit, in, len, i, HWY_MIN(len - i, line), out + o);
     }
-};
+    return o;
+}
 
-struct DecodeUnit : hn::UnrollerUnit<DecodeUnit, u8, u8> {
-    using D                      = hn::ScalableTag<u8>;
-    const hn::Vec<D> _3          = hn::Set(_du8, 3);
-    const hn::Vec<D> _0x2f       = hn::Set(_du8, 0x2f);
-    const hn::Vec<D> _0x40       = hn::Set(_du8, 0x40);
+template <class Alphabet, bool kWrite>
+struct DecodeUnit : hn::UnrollerUnit<DecodeUnit<Alphabet, kWrite>, u8, u8> {
     const hn::Vec<D> _0x01400140 = hn::BitCast(_du8, hn::Set(_du32, 0x01400140));
     const hn::Vec<D> _0x00011000 = hn::BitCast(_du8, hn::Set(_du32, 0x00011000));
     // clang-format off
@@ -113,62 +295,24 @@ struct DecodeUnit : hn::UnrollerUnit<DecodeUnit, u8, u8> {
         50, 49, 48, 54, 53, 52, 58, 57, 56, 62, 61, 60, 51, 55, 59, 63,  //
     };
     const hn::Vec<D> _lut = hn::LoadU(_du8, _lut_buf);
-    const hn::Vec<D> _shift_lut = hn::Dup128VecFromValues(_du8,
-        /* 0 */ 0x00,        /* 1 */ 0x00,        /* 2 */ 0x3e - 0x2b, /* 3 */ 0x34 - 0x30,
-        /* 4 */ 0x00 - 0x41, /* 5 */ 0x0f - 0x50, /* 6 */ 0x1a - 0x61, /* 7 */ 0x29 - 0x70,
-        /* 8 */ 0x00,        /* 9 */ 0x00,        /* a */ 0x00,        /* b */ 0x00,
-        /* c */ 0x00,        /* d */ 0x00,        /* e */ 0x00,        /* f */ 0x00
-    );
-
-    enum { hinv = 0, linv = 1 };
-    const hn::Vec<D> _lower_lut = hn::Dup128VecFromValues(_du8,
-        /* 0 */ linv, /* 1 */ linv, /* 2 */ 0x2b, /* 3 */ 0x30,
-        /* 4 */ 0x41, /* 5 */ 0x50, /* 6 */ 0x61, /* 7 */ 0x70,
-        /* 8 */ linv, /* 9 */ linv, /* a */ linv, /* b */ linv,
-        /* c */ linv, /* d */ linv, /* e */ linv, /* f */ linv
-    );
-    const hn::Vec<D> _upper_lut = hn::Dup128VecFromValues(_du8,
-        /* 0 */ hinv, /* 1 */ hinv, /* 2 */ 0x2b, /* 3 */ 0x39,
-        /* 4 */ 0x4f, /* 5 */ 0x5a, /* 6 */ 0x6f, /* 7 */ 0x7a,
-        /* 8 */ hinv, /* 9 */ hinv, /* a */ hinv, /* b */ hinv,
-        /* c */ hinv, /* d */ hinv, /* e */ hinv, /* f */ hinv
-    );
-
     // clang-format on
 
-    std::string_view _in;   // original input
-    const size_t _padding;  // padding count of the input
-    int _idx    = 0;
-    int _places = 0;  // places to store, positive means top, negative means bottom
-    DecodeUnit(std::string_view in, size_t padding) : _in(in), _padding(padding) {}
-
-    inline ptrdiff_t adjust_index(ptrdiff_t idx) const {
-        const size_t len = _in.size();
-        if (idx + N8 == len) {
-            return len - (len % 32);
-        } else {
-            return idx;
-        }
-    }
+    const Alphabet _alphabet;
+    ptrdiff_t _places = N8;  // valid lanes of the block being decoded
+    vu8 _bad          = hn::Zero(_du8);  // invalid lanes of every block, or-ed together
+    DecodeUnit(const Alphabet& alphabet) : _alphabet(alphabet) {}
 
     hn::Vec<D> Func(ptrdiff_t, const hn::Vec<D> xx, const hn::Vec<D> yy) {
-        const size_t len = _in.size();
-        /// lookup
-        // refer:
-        // https://github.com/WojciechMula/base64simd/blob/master/decode/lookup.sse.cpp
-        const auto higher_nibble = hn::ShiftRightSame(xx, 4);
-        const auto shift         = hn::TableLookupBytes(_shift_lut, higher_nibble);
-        const auto t0            = hn::Add(xx, shift);
-        const auto eq_2f         = hn::Eq(xx, _0x2f);
-        const auto result        = hn::IfThenElse(eq_2f, hn::Sub(t0, _3), t0);
-
-        /// check validity
-        const auto below   = hn::Lt(xx, hn::TableLookupBytes(_lower_lut, higher_nibble));
-        const auto above   = hn::Gt(xx, hn::TableLookupBytes(_upper_lut, higher_nibble));
-        const auto outside = hn::AndNot(eq_2f, hn::Or(below, above));
-        int j              = hn::FindFirstTrue(_du8, outside);
-        if (HWY_UNLIKELY(j != -1 && j < _places)) {
-            throw ss::input_error(j + _idx, _in[j + _idx]);
+        /// lookup, the first bad lane is only looked for after the loop
+        hn::Mask<D> outside;
+        const auto result = _alphabet.Decode(xx, outside);
+        auto bad          = hn::VecFromMask(_du8, outside);
+        if (HWY_UNLIKELY(_places < (ptrdiff_t)N8)) {
+            bad = hn::IfThenElseZero(hn::FirstN(_du8, _places), bad);
+        }
+        _bad = hn::Or(_bad, bad);
+        if constexpr (!kWrite) {
+            return hn::Zero(_du8);
         }
 
         /// decode
@@ -186,12 +330,14 @@ struct DecodeUnit : hn::UnrollerUnit<DecodeUnit, u8, u8> {
             i = idx + places + N8;
             p = -places;
         }
-        _idx    = i;
         _places = p;
-        return me()->MaskLoadImpl(i, from, p);
+        return this->me()->MaskLoadImpl(i, from, p);
     }
 
     bool StoreAndShortCircuitImpl(const ptrdiff_t idx, uint8_t* to, const hn::Vec<D> x) {
+        if constexpr (!kWrite) {
+            return true;
+        }
         /// indexof(src):indexof(dest) => 4:3
         //    src:  x x x o | x x x o
         //    dest: x x x | x x x
@@ -208,6 +354,9 @@ struct DecodeUnit : hn::UnrollerUnit<DecodeUnit, u8, u8> {
 
     ptrdiff_t
     MaskStoreImpl(const ptrdiff_t idx, u8* to, const hn::Vec<D> x, const ptrdiff_t places) {
+        if constexpr (!kWrite) {
+            return 0;
+        }
         /// convert neg places
         ptrdiff_t i = idx;
         ptrdiff_t p = places;
@@ -219,12 +368,8 @@ struct DecodeUnit : hn::UnrollerUnit<DecodeUnit, u8, u8> {
         ptrdiff_t j                = i * 3 / 4;
         constexpr size_t count     = 12;  // 16 * 3 / 4
         constexpr size_t multiples = N8 / 16;
-        int left                   = p / 4 * 3;  // 4:3
-        switch (_padding) {
-        case 1: left += 2; break;  // 4:3
-        case 2: left += 1; break;  // 4:3
-        default: break;            // no padding
-        }
+        // 4:3, and a final group of 2 or 3 chars holds 1 or 2 bytes
+        int left = p / 4 * 3 + (p % 4 > 1 ? p % 4 - 1 : 0);
 
         const size_t z            = left;
         HWY_ALIGN uint8_t buf[64] = {0};
@@ -234,35 +379,573 @@ struct DecodeUnit : hn::UnrollerUnit<DecodeUnit, u8, u8> {
         }
         return z;
     }
+
+    // Only on the error path: where the first bad byte is.
+    size_t FirstBad(const u8* from, size_t len) const {
+        for (size_t i = 0; i < len; i += N8) {
+            const size_t n = HWY_MIN(N8, len - i);
+            hn::Mask<D> outside;
+            _alphabet.Decode(hn::LoadN(_du8, from + i, n), outside);
+            const intptr_t j = hn::FindFirstTrue(_du8, hn::And(outside, hn::FirstN(_du8, n)));
+            if (j >= 0) {
+                return i + j;
+            }
+        }
+        return len;
+    }
 };
 
+template <bool kWrite>
+ss::decode_result DecodeBody(const char* in, size_t len, const ss::base64_options& opts,
+                             char* out) {
+    const size_t padding = base64_padding_count(in, len);
+    if (HWY_UNLIKELY(padding > 2
+                     || (padding > 0 && opts.padding == ss::base64_padding::forbidden))) {
+        return {0, len - padding, ss::decode_error::invalid_padding};
+    }
+    // a lone char cannot hold a byte; padded input comes in whole groups
+    const size_t n      = len - padding;
+    const bool grouped  = padding > 0 || opts.padding == ss::base64_padding::required;
+    if (HWY_UNLIKELY(grouped ? len % 4 != 0 : n % 4 == 1)) {
+        return {0, len, ss::decode_error::invalid_length};
+    }
+    return WithAlphabet(*opts.alphabet, [&](const auto& alphabet) -> ss::decode_result {
+        DecodeUnit<std::decay_t<decltype(alphabet)>, kWrite> unit(alphabet);
+        hn::Unroller(unit, (u8*)(const_cast<char*>(in)), (u8*)out, n);
+        if (HWY_UNLIKELY(!hn::AllFalse(_du8, hn::MaskFromVec(unit._bad)))) {
+            const size_t ofs = unit.FirstBad((const u8*)in, n);
+            return {0, ofs,
+                    in[ofs] == '=' ? ss::decode_error::invalid_padding
+                                   : ss::decode_error::invalid_byte};
+        }
+        return {n / 4 * 3 + (n % 4 ? n % 4 - 1 : 0), 0, ss::decode_error::none};
+    });
+}
+
+// ASCII whitespace: '\t' '\n' '\v' '\f' '\r' and ' '.
+struct SpaceMatch {
+    const vu8 _space = hn::Set(_du8, ' ');
+    const vu8 _9     = hn::Set(_du8, 9);
+    const vu8 _5     = hn::Set(_du8, 5);
+
+    HWY_INLINE hn::Mask<D> operator()(vu8 v) const {
+        return hn::Or(hn::Eq(v, _space), hn::Lt(hn::Sub(v, _9), _5));
+    }
+};
+
+// Copy the bytes of `in` that are not whitespace to `out`, return how many.
+size_t CompactSpace(const u8* in, size_t len, u8* out) {
+    const SpaceMatch space;
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + N8 <= len; i += N8) {
+        const vu8 v  = hn::LoadU(_du8, in + i);
+        const auto m = space(v);
+        if (HWY_LIKELY(hn::AllFalse(_du8, m))) {
+            hn::StoreU(v, _du8, out + n);
+            n += N8;
+        } else {
+            n += hn::CompressBlendedStore(v, hn::Not(m), _du8, out + n);
+        }
+    }
+    if (i < len) {
+        const vu8 v = hn::LoadN(_du8, in + i, len - i);
+        n += hn::CompressBlendedStore(v, hn::AndNot(space(v), hn::FirstN(_du8, len - i)), _du8,
+                                      out + n);
+    }
+    return n;
+}
+
+// Whitespace is compressed out a vector at a time into an L1-sized block,
+// whose whole groups are decoded as it fills. Offsets in the result count the
+// kept chars only; the caller maps them back to the text.
+template <bool kWrite>
+ss::decode_result DecodeSpaced(const char* in, size_t len, const ss::base64_options& opts,
+                               char* out) {
+    constexpr size_t kBlock = 4096;
+    HWY_ALIGN u8 block[kBlock];
+    auto tail       = opts;
+    tail.skip_space = false;
+    // padding may only end the text, so the blocks before must be whole groups
+    auto whole = tail;
+    if (whole.padding == ss::base64_padding::optional) {
+        whole.padding = ss::base64_padding::required;
+    }
+
+    size_t fill = 0;  // kept chars in the block
+    size_t done = 0;  // kept chars decoded
+    size_t size = 0;
+    bool padded = false;
+    for (size_t i = 0;;) {
+        const size_t take = HWY_MIN(len - i, kBlock - fill);
+        fill += CompactSpace((const u8*)in + i, take, block + fill);
+        i += take;
+        if (HWY_UNLIKELY(padded && fill > 0)) {
+            return {0, done, ss::decode_error::invalid_padding};
+        }
+        const bool last = i == len;
+        const size_t n  = last ? fill : fill / 4 * 4;
+        auto r = DecodeBody<kWrite>((const char*)block, n, last ? tail : whole,
+                                    kWrite ? out + size : nullptr);
+        if (HWY_UNLIKELY(!r)) {
+            r.offset += done;
+            return r;
+        }
+        size += r.size;
+        if (last) {
+            return {size, 0, ss::decode_error::none};
+        }
+        padded = r.size < n / 4 * 3;
+        done += n;
+        fill -= n;
+        memmove(block, block + n, fill);
+    }
+}
+
 }  // namespace
 
+size_t Base64Encode(const char* in, size_t len, const ss::base64_options& opts, char* out) {
+    size_t olen = WithAlphabet(*opts.alphabet, [&](const auto& alphabet) {
+        return opts.wrap == 0 ? EncodeBody(alphabet, (const u8*)in, len, (u8*)out)
+                              : EncodeLines(alphabet, (const u8*)in, len, opts, (u8*)out);
+    });
+    if (opts.padding != ss::base64_padding::forbidden) {
+        for (size_t k = len % 3; k % 3 != 0; ++k) {
+            out[olen++] = '=';
+        }
+    }
+    return olen;
+}
+
+ss::decode_result
+Base64Decode(const char* in, size_t len, const ss::base64_options& opts, char* out) {
+    return opts.skip_space ? DecodeSpaced<true>(in, len, opts, out)
+                           : DecodeBody<true>(in, len, opts, out);
+}
+
+ss::decode_result Base64Validate(const char* in, size_t len, const ss::base64_options& opts) {
+    return opts.skip_space ? DecodeSpaced<false>(in, len, opts, nullptr)
+                           : DecodeBody<false>(in, len, opts, nullptr);
+}
+
+size_t Base64Compact(const char* in, size_t len, char* out) {
+    return CompactSpace((const u8*)in, len, (u8*)out);
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+
 namespace ss {
 
-std::string base64_encode(const char* in, size_t len) {
-    EncodeUnit unit;
-    const size_t mod = len % 3;
-    size_t olen      = base64_encode_size(in, len);
-    std::string result(olen, '\0');
-    hn::Unroller(unit, (u8*)(const_cast<char*>(in)), (u8*)result.data(), olen);
-    if (mod > 0) {
-        // padding
-        int pad = 3 - mod;
-        for (int i = 0, j = olen - 1; i < pad; ++i, --j) {
-            result[j] = '=';
+HWY_EXPORT(Base64Encode);
+HWY_EXPORT(Base64Decode);
+HWY_EXPORT(Base64Validate);
+HWY_EXPORT(Base64Compact);
+
+namespace {
+
+static inline bool is_space(char c) {
+    return c == ' ' || (uint8_t)(c - '\t') < 5;
+}
+
+// Offset in `in` of the `k`th byte that is not whitespace.
+static size_t kept_offset(const char* in, size_t len, size_t k) {
+    for (size_t i = 0; i < len; ++i) {
+        if (!is_space(in[i]) && k-- == 0) {
+            return i;
         }
     }
+    return len;
+}
+
+// With skip_space the kernels count offsets in kept chars only.
+decode_result text_offset(decode_result r, const char* in, size_t len,
+                          const base64_options& opts) {
+    if (HWY_UNLIKELY(!r && opts.skip_space)) {
+        r.offset = r.error == decode_error::invalid_length ? len : kept_offset(in, len, r.offset);
+    }
+    return r;
+}
+
+void check_wrap(const base64_options& opts) {
+    if (HWY_UNLIKELY(opts.wrap % 4 != 0)) {
+        throw std::runtime_error("Invalid base64 line length");
+    }
+}
+
+// What the throwing decoders raise for a failed `r`.
+[[noreturn]] void throw_base64_error(const decode_result& r, const char* in) {
+    switch (r.error) {
+    case decode_error::invalid_length: throw std::runtime_error("Invalid base64 text size");
+    case decode_error::output_too_small: throw std::length_error("Output buffer too small");
+    default: throw input_error(r.offset, in[r.offset]);
+    }
+}
+
+}  // namespace
+
+size_t base64_encode(const char* in, size_t len, const base64_options& opts, char* out,
+                     size_t cap) {
+    check_wrap(opts);
+    if (HWY_UNLIKELY(cap < base64_encode_size(in, len, opts))) {
+        throw std::length_error("Output buffer too small");
+    }
+    return HWY_DYNAMIC_DISPATCH(Base64Encode)(in, len, opts, out);
+}
+
+size_t base64_encode(const char* in, size_t len, const base64_options& opts, std::string& out) {
+    check_wrap(opts);
+    const size_t pos = out.size();
+    out.resize(pos + base64_encode_size(in, len, opts));
+    return HWY_DYNAMIC_DISPATCH(Base64Encode)(in, len, opts, &out[pos]);
+}
+
+decode_result try_base64_decode(const char* in, size_t len, const base64_options& opts,
+                                char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < base64_decode_size(in, len))) {
+        return {0, 0, decode_error::output_too_small};
+    }
+    return text_offset(HWY_DYNAMIC_DISPATCH(Base64Decode)(in, len, opts, out), in, len, opts);
+}
+
+decode_result try_base64_decode(const char* in, size_t len, const base64_options& opts,
+                                std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + base64_decode_size(in, len));
+    const auto r = HWY_DYNAMIC_DISPATCH(Base64Decode)(in, len, opts, &out[pos]);
+    out.resize(pos + r.size);
+    return text_offset(r, in, len, opts);
+}
+
+decode_result base64_validate(const char* in, size_t len, const base64_options& opts) {
+    return text_offset(HWY_DYNAMIC_DISPATCH(Base64Validate)(in, len, opts), in, len, opts);
+}
+
+size_t base64_decode(const char* in, size_t len, const base64_options& opts, char* out,
+                     size_t cap) {
+    const auto r = try_base64_decode(in, len, opts, out, cap);
+    if (HWY_UNLIKELY(!r)) {
+        throw_base64_error(r, in);
+    }
+    return r.size;
+}
+
+size_t base64_decode(const char* in, size_t len, const base64_options& opts, std::string& out) {
+    const auto r = try_base64_decode(in, len, opts, out);
+    if (HWY_UNLIKELY(!r)) {
+        throw_base64_error(r, in);
+    }
+    return r.size;
+}
+
+std::string base64_encode(const char* in, size_t len, const base64_options& opts) {
+    std::string result;
+    base64_encode(in, len, opts, result);
     return result;
 }
 
-std::string base64_decode(const char* in, size_t len) {
-    const size_t padding = base64_padding_count(in, len);
-    size_t olen          = base64_decode_size(in, len);
-    std::string result(olen, '\0');
-    DecodeUnit unit(std::string_view(in, len - padding), padding);
-    hn::Unroller(unit, (u8*)(const_cast<char*>(in)), (u8*)result.data(), len - padding);
+std::string base64_decode(const char* in, size_t len, const base64_options& opts) {
+    std::string result;
+    base64_decode(in, len, opts, result);
     return result;
 }
 
+size_t base64_encode(const char* in, size_t len, char* out, size_t cap) {
+    return base64_encode(in, len, base64_options{}, out, cap);
+}
+
+size_t base64_encode(const char* in, size_t len, std::string& out) {
+    return base64_encode(in, len, base64_options{}, out);
+}
+
+decode_result try_base64_decode(const char* in, size_t len, char* out, size_t cap) {
+    return try_base64_decode(in, len, base64_options{}, out, cap);
+}
+
+decode_result try_base64_decode(const char* in, size_t len, std::string& out) {
+    return try_base64_decode(in, len, base64_options{}, out);
+}
+
+decode_result base64_validate(const char* in, size_t len) {
+    return base64_validate(in, len, base64_options{});
+}
+
+size_t base64_decode(const char* in, size_t len, char* out, size_t cap) {
+    return base64_decode(in, len, base64_options{}, out, cap);
+}
+
+size_t base64_decode(const char* in, size_t len, std::string& out) {
+    return base64_decode(in, len, base64_options{}, out);
+}
+
+std::string base64_encode(const char* in, size_t len) {
+    return base64_encode(in, len, base64_options{});
+}
+
+std::string base64_decode(const char* in, size_t len) {
+    return base64_decode(in, len, base64_options{});
+}
+
+base64_encoder::base64_encoder(const base64_options& opts) : opts_(opts) {
+    check_wrap(opts);
+}
+
+// Whole groups, continuing the current line.
+size_t base64_encoder::put(const char* in, size_t len, char* out) {
+    if (opts_.wrap == 0 || len == 0) {
+        return HWY_DYNAMIC_DISPATCH(Base64Encode)(in, len, opts_, out);
+    }
+    size_t n = 0;
+    if (column_ > 0 && column_ < opts_.wrap) {
+        auto line         = opts_;
+        line.wrap         = 0;
+        const size_t take = HWY_MIN(len, (opts_.wrap - column_) / 4 * 3);
+        n                 = HWY_DYNAMIC_DISPATCH(Base64Encode)(in, take, line, out);
+        column_ += n;
+        in += take;
+        len -= take;
+        if (len == 0) {
+            return n;
+        }
+    }
+    if (column_ == opts_.wrap) {
+        memcpy(out + n, opts_.newline.data(), opts_.newline.size());
+        n += opts_.newline.size();
+    }
+    n += HWY_DYNAMIC_DISPATCH(Base64Encode)(in, len, opts_, out + n);
+    column_ = (len / 3 * 4 - 1) % opts_.wrap + 1;
+    return n;
+}
+
+size_t base64_encoder::update(const char* in, size_t len, char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < update_size(len))) {
+        throw std::length_error("Output buffer too small");
+    }
+
+    size_t n = 0;
+    if (ncarry_ > 0) {
+        const size_t take = HWY_MIN(3 - ncarry_, len);
+        memcpy(carry_ + ncarry_, in, take);
+        ncarry_ += take;
+        in += take;
+        len -= take;
+        if (ncarry_ < 3) {
+            return 0;
+        }
+        n = put(carry_, 3, out);
+    }
+
+    const size_t bulk = len / 3 * 3;
+    n += put(in, bulk, out + n);
+    ncarry_ = len - bulk;
+    memcpy(carry_, in + bulk, ncarry_);
+    return n;
+}
+
+size_t base64_encoder::update(const char* in, size_t len, std::string& out) {
+    const size_t pos  = out.size();
+    const size_t olen = update_size(len);
+    out.resize(pos + olen);
+    const size_t n = update(in, len, &out[pos], olen);
+    out.resize(pos + n);
+    return n;
+}
+
+size_t base64_encoder::final(char* out, size_t cap) {
+    const size_t n = final_size();
+    if (HWY_UNLIKELY(cap < n)) {
+        throw std::length_error("Output buffer too small");
+    }
+    if (n > 0) {
+        size_t k = 0;
+        if (opts_.wrap > 0 && column_ == opts_.wrap) {
+            memcpy(out, opts_.newline.data(), opts_.newline.size());
+            k = opts_.newline.size();
+        }
+        auto line = opts_;
+        line.wrap = 0;
+        HWY_DYNAMIC_DISPATCH(Base64Encode)(carry_, ncarry_, line, out + k);
+    }
+    ncarry_ = 0;
+    column_ = 0;
+    return n;
+}
+
+size_t base64_encoder::final(std::string& out) {
+    const size_t pos  = out.size();
+    const size_t olen = final_size();
+    out.resize(pos + olen);
+    return final(&out[pos], olen);
+}
+
+// Offsets are counted in chars, whitespace excluded.
+size_t base64_decoder::put(const char* in, size_t len, char* out) {
+    auto opts       = opts_;
+    opts.skip_space = false;
+    if (HWY_UNLIKELY(done_ && len > 0)) {
+        throw ss::input_error(offset_, in[0]);
+    }
+
+    size_t n = 0;
+    if (ncarry_ > 0) {
+        const size_t take = HWY_MIN(4 - ncarry_, len);
+        memcpy(carry_ + ncarry_, in, take);
+        ncarry_ += take;
+        in += take;
+        len -= take;
+        if (ncarry_ < 4) {
+            return 0;
+        }
+        const auto r = HWY_DYNAMIC_DISPATCH(Base64Decode)(carry_, 4, opts, out);
+        if (HWY_UNLIKELY(!r)) {
+            throw ss::input_error(offset_ + r.offset, carry_[r.offset]);
+        }
+        n       = r.size;
+        ncarry_ = 0;
+        offset_ += 4;
+        done_ = n < 3;
+        if (HWY_UNLIKELY(done_ && len > 0)) {
+            throw ss::input_error(offset_, in[0]);
+        }
+    }
+
+    const size_t bulk = len / 4 * 4;
+    if (bulk > 0) {
+        const char* last     = in + bulk - 4;
+        const size_t padding = (last[3] == '=') + (last[2] == '=') + (last[1] == '=');
+        if (HWY_UNLIKELY(padding > 2)) {
+            throw ss::input_error(offset_ + bulk - padding, '=');
+        }
+        if (HWY_UNLIKELY(padding > 0 && len > bulk)) {
+            throw ss::input_error(offset_ + bulk, in[bulk]);
+        }
+        const auto r = HWY_DYNAMIC_DISPATCH(Base64Decode)(in, bulk, opts, out + n);
+        if (HWY_UNLIKELY(!r)) {
+            throw ss::input_error(offset_ + r.offset, in[r.offset]);
+        }
+        n += r.size;
+        offset_ += bulk;
+        done_ = padding > 0;
+    }
+    ncarry_ = len - bulk;
+    memcpy(carry_, in + bulk, ncarry_);
+    return n;
+}
+
+size_t base64_decoder::update(const char* in, size_t len, char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < update_size(len))) {
+        throw std::length_error("Output buffer too small");
+    }
+    if (!opts_.skip_space) {
+        return put(in, len, out);
+    }
+
+    // whitespace is compressed out a block at a time, error offsets are mapped
+    // back through the carried chars and the block
+    char block[4096];
+    size_t n = 0;
+    for (size_t i = 0; i < len; i += sizeof(block)) {
+        const char* piece   = in + i;
+        const size_t take   = HWY_MIN(len - i, sizeof(block));
+        const size_t kept   = HWY_DYNAMIC_DISPATCH(Base64Compact)(piece, take, block);
+        const size_t offset = offset_;
+        const size_t ncarry = ncarry_;
+        size_t at[4];
+        memcpy(at, carry_at_, sizeof(at));
+        try {
+            n += put(block, kept, out + n);
+        } catch (const ss::input_error& e) {
+            const size_t k = e.offset() - offset;
+            if (k < ncarry) {
+                throw ss::input_error(at[k], carry_[k]);
+            }
+            const size_t j = kept_offset(piece, take, k - ncarry);
+            throw ss::input_error(raw_ + j, piece[j]);
+        }
+        // the carried chars are the last kept ones, of this block then of the old carry
+        size_t c = ncarry_;
+        for (size_t j = take; c > 0 && j > 0; --j) {
+            if (!is_space(piece[j - 1])) {
+                carry_at_[--c] = raw_ + j - 1;
+            }
+        }
+        for (size_t k = ncarry; c > 0;) {
+            carry_at_[--c] = at[--k];
+        }
+        raw_ += take;
+    }
+    return n;
+}
+
+size_t base64_decoder::update(const char* in, size_t len, std::string& out) {
+    const size_t pos  = out.size();
+    const size_t olen = update_size(len);
+    out.resize(pos + olen);
+    try {
+        const size_t n = update(in, len, &out[pos], olen);
+        out.resize(pos + n);
+        return n;
+    } catch (...) {
+        out.resize(pos);
+        throw;
+    }
+}
+
+size_t base64_decoder::final(char* out, size_t cap) {
+    const size_t n = final_size();
+    if (HWY_UNLIKELY(cap < n)) {
+        throw std::length_error("Output buffer too small");
+    }
+    const size_t left   = ncarry_;
+    const size_t offset = offset_;
+    ncarry_             = 0;
+    offset_             = 0;
+    raw_                = 0;
+    done_               = false;
+    if (left == 0) {
+        return 0;
+    }
+    if (HWY_UNLIKELY(left == 1 || opts_.padding == base64_padding::required)) {
+        throw std::runtime_error("Invalid base64 text size");
+    }
+    auto opts       = opts_;
+    opts.skip_space = false;
+    const auto r    = HWY_DYNAMIC_DISPATCH(Base64Decode)(carry_, left, opts, out);
+    if (HWY_UNLIKELY(!r)) {
+        const size_t at = opts_.skip_space ? carry_at_[r.offset] : offset + r.offset;
+        throw ss::input_error(at, carry_[r.offset]);
+    }
+    return r.size;
+}
+
+size_t base64_decoder::final(std::string& out) {
+    const size_t pos  = out.size();
+    const size_t olen = final_size();
+    out.resize(pos + olen);
+    try {
+        const size_t n = final(&out[pos], olen);
+        out.resize(pos + n);
+        return n;
+    } catch (...) {
+        out.resize(pos);
+        throw;
+    }
+}
+
+void base64_decoder::final() {
+    const size_t left = ncarry_;
+    ncarry_           = 0;
+    offset_           = 0;
+    raw_              = 0;
+    done_             = false;
+    if (HWY_UNLIKELY(left > 0)) {
+        throw std::runtime_error("Invalid base64 text size");
+    }
+}
+
 }  // namespace ss
+
+#endif  // HWY_ONCE
@@ -1,18 +1,20 @@
 #include <algorithm>
-#include <hwy/contrib/unroller/unroller-inl.h>
-#include <hwy/highway.h>
 #include <limits.h>
+#include <stdexcept>
 #include <string.h>
 #include <strings/core.h>
 #include <strings/object.h>
 
-namespace hn = hwy::HWY_NAMESPACE;
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "src/core.cpp"
+#include <hwy/foreach_target.h>  // IWYU pragma: keep
 
-static HWY_FULL(uint8_t) _du8;
-using vec8_t               = hn::Vec<decltype(_du8)>;
-static constexpr size_t N8 = hn::Lanes(_du8);
+#include "detail/hwy.h"
+#include <hwy/contrib/unroller/unroller-inl.h>
 
+HWY_BEFORE_NAMESPACE();
 namespace ss {
+namespace HWY_NAMESPACE {
 
 namespace detail {
 
@@ -46,6 +48,673 @@ struct LowerUnit : hn::UnrollerUnit<LowerUnit, uint8_t, uint8_t> {
     }
 };
 
+struct ReplaceByteUnit : hn::UnrollerUnit<ReplaceByteUnit, uint8_t, uint8_t> {
+    using TT = hn::ScalableTag<uint8_t>;
+    inline static constexpr TT _d{};
+    const hn::Vec<TT> from;
+    const hn::Vec<TT> to;
+
+    ReplaceByteUnit(uint8_t f, uint8_t t) : from(hn::Set(_d, f)), to(hn::Set(_d, t)) {}
+
+    hn::Vec<TT> Func(ptrdiff_t idx, const hn::Vec<TT> xx, const hn::Vec<TT> yy) {
+        (void)idx;
+        (void)yy;
+        return hn::IfThenElse(hn::Eq(xx, from), to, xx);
+    }
+};
+
+// A 256-byte table as 16 rows of 16: the high nibble picks the row, a
+// TableLookupBytes on the low nibble picks the byte.
+struct TranslateUnit : hn::UnrollerUnit<TranslateUnit, uint8_t, uint8_t> {
+    using TT = hn::ScalableTag<uint8_t>;
+    inline static constexpr TT _d{};
+    const hn::Vec<TT> _0x0f = hn::Set(_d, 0x0f);
+    hn::Vec<TT> rows[16];
+
+    explicit TranslateUnit(const uint8_t* table) {
+        for (size_t i = 0; i < 16; ++i) {
+            rows[i] = hn::LoadDup128(_d, table + i * 16);
+        }
+    }
+
+    hn::Vec<TT> Func(ptrdiff_t idx, const hn::Vec<TT> xx, const hn::Vec<TT> yy) {
+        (void)idx;
+        (void)yy;
+        const auto lo = hn::And(xx, _0x0f);
+        const auto hi = hn::ShiftRight<4>(xx);
+        auto result   = hn::TableLookupBytes(rows[0], lo);
+        for (size_t i = 1; i < 16; ++i) {
+            const auto row = hn::TableLookupBytes(rows[i], lo);
+            result         = hn::IfThenElse(hn::Eq(hi, hn::Set(_d, (uint8_t)i)), row, result);
+        }
+        return result;
+    }
+};
+
+}  // namespace detail
+
+// Full vectors, then one masked vector for the tail. Each vector is loaded
+// before it is stored, so `out` may equal `in`.
+template <class Unit>
+HWY_INLINE void MapBytes(Unit& unit, const char* in, size_t len, char* out) {
+    const auto* src = reinterpret_cast<const uint8_t*>(in);
+    auto* dst       = reinterpret_cast<uint8_t*>(out);
+    const auto zero = hn::Zero(_du8);
+    size_t idx      = 0;
+    for (; idx + N8 <= len; idx += N8) {
+        hn::StoreU(unit.Func(0, hn::LoadU(_du8, src + idx), zero), _du8, dst + idx);
+    }
+    if (idx != len) {
+        const size_t n = len - idx;
+        hn::StoreN(unit.Func(0, hn::LoadN(_du8, src + idx, n), zero), _du8, dst + idx, n);
+    }
+}
+
+void StrToUpper(const char* in, size_t len, char* out) {
+    detail::UpperUnit unit;
+    MapBytes(unit, in, len, out);
+}
+
+void StrToLower(const char* in, size_t len, char* out) {
+    detail::LowerUnit unit;
+    MapBytes(unit, in, len, out);
+}
+
+void StrReplaceByte(const char* in, size_t len, char from, char to, char* out) {
+    detail::ReplaceByteUnit unit((uint8_t)from, (uint8_t)to);
+    MapBytes(unit, in, len, out);
+}
+
+void StrTranslate(const char* in, size_t len, const uint8_t* table, char* out) {
+    detail::TranslateUnit unit(table);
+    MapBytes(unit, in, len, out);
+}
+
+// Lower-cases with LowerUnit when kFold, identity otherwise.
+template <bool kFold>
+struct Folder {
+    detail::LowerUnit lower;
+    const vu8 zero = hn::Zero(_du8);
+
+    HWY_INLINE vu8 operator()(vu8 v) {
+        if constexpr (kFold) {
+            return lower.Func(0, v, zero);
+        } else {
+            return v;
+        }
+    }
+};
+
+// Folds (if kFold) both sides and compares in the same pass.
+template <bool kFold>
+HWY_INLINE bool FoldEqual(const uint8_t* a, const uint8_t* b, size_t len) {
+    Folder<kFold> fold;
+    size_t idx = 0;
+    for (; idx + N8 <= len; idx += N8) {
+        const auto x = fold(hn::LoadU(_du8, a + idx));
+        const auto y = fold(hn::LoadU(_du8, b + idx));
+        if (!hn::AllTrue(_du8, hn::Eq(x, y))) {
+            return false;
+        }
+    }
+    if (idx != len) {
+        const size_t n = len - idx;
+        const auto x   = fold(hn::LoadN(_du8, a + idx, n));
+        const auto y   = fold(hn::LoadN(_du8, b + idx, n));
+        return hn::AllTrue(_du8, hn::Eq(x, y));
+    }
+    return true;
+}
+
+bool StrIEquals(const char* a, const char* b, size_t len) {
+    return FoldEqual<true>((const uint8_t*)a, (const uint8_t*)b, len);
+}
+
+// Candidates are positions whose first and last bytes match the needle, each
+// verified with FoldEqual. Calls on_match(pos) for every occurrence that does
+// not overlap the previous one, until it returns false. Requires 0 < m <= n.
+template <bool kFold, class F>
+HWY_INLINE void ScanImpl(const char* hay, size_t n, const char* needle, size_t m, F&& on_match) {
+    Folder<kFold> fold;
+    const auto* h      = (const uint8_t*)hay;
+    const auto* p      = (const uint8_t*)needle;
+    const auto first   = fold(hn::Set(_du8, p[0]));
+    const auto last    = fold(hn::Set(_du8, p[m - 1]));
+    const size_t inner = m > 2 ? m - 2 : 0;
+    const size_t npos  = n - m + 1;  // candidate positions
+    size_t next        = 0;          // end of the previous match
+
+    // false once on_match() asked to stop
+    auto verify = [&](size_t idx, hn::Mask<decltype(_du8)> candidates) -> bool {
+        uint8_t bytes[8] = {0};
+        hn::StoreMaskBits(_du8, candidates, bytes);
+        uint64_t bits;
+        memcpy(&bits, bytes, sizeof(bits));
+        while (bits != 0) {
+            const size_t pos = idx + hwy::Num0BitsBelowLS1Bit_Nonzero64(bits);
+            bits &= bits - 1;
+            if (pos >= next && FoldEqual<kFold>(h + pos + 1, p + 1, inner)) {
+                if (!on_match(pos)) {
+                    return false;
+                }
+                next = pos + m;
+            }
+        }
+        return true;
+    };
+
+    size_t idx = 0;
+    for (; idx + N8 <= npos; idx += N8) {
+        const auto a = fold(hn::LoadU(_du8, h + idx));
+        const auto b = fold(hn::LoadU(_du8, h + idx + m - 1));
+        const auto c = hn::And(hn::Eq(a, first), hn::Eq(b, last));
+        if (!hn::AllFalse(_du8, c) && !verify(idx, c)) {
+            return;
+        }
+    }
+    if (idx != npos) {
+        const size_t cnt = npos - idx;
+        const auto a     = fold(hn::LoadN(_du8, h + idx, cnt));
+        const auto b     = fold(hn::LoadN(_du8, h + idx + m - 1, cnt));
+        const auto c =
+            hn::And(hn::And(hn::Eq(a, first), hn::Eq(b, last)), hn::FirstN(_du8, cnt));
+        verify(idx, c);
+    }
+}
+
+template <bool kFold>
+HWY_INLINE size_t FindImpl(const char* hay, size_t n, const char* needle, size_t m) {
+    size_t r = std::string_view::npos;
+    ScanImpl<kFold>(hay, n, needle, m, [&](size_t pos) {
+        r = pos;
+        return false;
+    });
+    return r;
+}
+
+size_t StrFind(const char* hay, size_t n, const char* needle, size_t m) {
+    return FindImpl<false>(hay, n, needle, m);
+}
+
+size_t StrIFind(const char* hay, size_t n, const char* needle, size_t m) {
+    return FindImpl<true>(hay, n, needle, m);
+}
+
+// Raita: Horspool shifts on the window's last byte, which is compared first,
+// then the first and middle bytes, then the rest. Requires 2 < m <= n.
+template <class F>
+HWY_INLINE void RaitaImpl(const char* hay, size_t n, const char* needle, size_t m,
+                          const uint32_t* skip, F&& on_match) {
+    const auto* h    = (const uint8_t*)hay;
+    const auto* p    = (const uint8_t*)needle;
+    const uint8_t p0 = p[0];
+    const uint8_t pm = p[m / 2];
+    const uint8_t pl = p[m - 1];
+    size_t pos       = 0;
+    while (pos + m <= n) {
+        const uint8_t c = h[pos + m - 1];
+        if (c == pl && h[pos] == p0 && h[pos + m / 2] == pm &&
+            FoldEqual<false>(h + pos + 1, p + 1, m - 2)) {
+            if (!on_match(pos)) {
+                return;
+            }
+            pos += m;
+        } else {
+            pos += skip[c];
+        }
+    }
+}
+
+// `skip` is null for needles short enough for the SIMD filter.
+template <class F>
+HWY_INLINE void SearchImpl(const char* hay, size_t n, const char* needle, size_t m,
+                           const uint32_t* skip, F&& on_match) {
+    if (skip != nullptr) {
+        RaitaImpl(hay, n, needle, m, skip, on_match);
+    } else {
+        ScanImpl<false>(hay, n, needle, m, on_match);
+    }
+}
+
+size_t SearcherFind(const char* hay, size_t n, const char* needle, size_t m,
+                    const uint32_t* skip) {
+    size_t r = std::string_view::npos;
+    SearchImpl(hay, n, needle, m, skip, [&](size_t pos) {
+        r = pos;
+        return false;
+    });
+    return r;
+}
+
+size_t SearcherCount(const char* hay, size_t n, const char* needle, size_t m,
+                     const uint32_t* skip) {
+    size_t count = 0;
+    SearchImpl(hay, n, needle, m, skip, [&](size_t) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+void SearcherFindAll(const char* hay, size_t n, const char* needle, size_t m,
+                     const uint32_t* skip, std::vector<size_t>& out) {
+    SearchImpl(hay, n, needle, m, skip, [&](size_t pos) {
+        out.push_back(pos);
+        return true;
+    });
+}
+
+// The SIMD filter run from the end, taking candidates from the highest bit.
+// Requires 0 < m <= n.
+size_t SearcherRFind(const char* hay, size_t n, const char* needle, size_t m) {
+    const auto* h      = (const uint8_t*)hay;
+    const auto* p      = (const uint8_t*)needle;
+    const auto first   = hn::Set(_du8, p[0]);
+    const auto last    = hn::Set(_du8, p[m - 1]);
+    const size_t inner = m > 2 ? m - 2 : 0;
+
+    auto verify = [&](size_t idx, hn::Mask<decltype(_du8)> candidates) -> size_t {
+        uint8_t bytes[8] = {0};
+        hn::StoreMaskBits(_du8, candidates, bytes);
+        uint64_t bits;
+        memcpy(&bits, bytes, sizeof(bits));
+        while (bits != 0) {
+            const size_t k = 63 - hwy::Num0BitsAboveMS1Bit_Nonzero64(bits);
+            if (FoldEqual<false>(h + idx + k + 1, p + 1, inner)) {
+                return idx + k;
+            }
+            bits &= ~(1ull << k);
+        }
+        return std::string_view::npos;
+    };
+
+    size_t end = n - m + 1;  // candidate positions below `end` are left
+    for (; end >= N8; end -= N8) {
+        const size_t idx = end - N8;
+        const auto c     = hn::And(hn::Eq(hn::LoadU(_du8, h + idx), first),
+                                   hn::Eq(hn::LoadU(_du8, h + idx + m - 1), last));
+        if (!hn::AllFalse(_du8, c)) {
+            const size_t r = verify(idx, c);
+            if (r != std::string_view::npos) {
+                return r;
+            }
+        }
+    }
+    if (end != 0) {
+        const auto c = hn::And(hn::Eq(hn::LoadN(_du8, h, end), first),
+                               hn::Eq(hn::LoadN(_du8, h + m - 1, end), last));
+        return verify(0, hn::And(c, hn::FirstN(_du8, end)));
+    }
+    return std::string_view::npos;
+}
+
+// Teddy: lanes whose first k bytes all hit a common bucket are candidates;
+// the patterns of those buckets are compared in full. Returns false if fn
+// stopped the scan.
+bool MultiTeddy(const char* hay, size_t n, const ss::detail::teddy_plan& plan,
+                ss::detail::match_fn fn, void* ctx) {
+    const size_t k = plan.k;
+    if (n < k) {
+        return true;
+    }
+    const auto* h   = (const uint8_t*)hay;
+    const auto zero = hn::Zero(_du8);
+    const auto low  = hn::Set(_du8, 0x0f);
+    vu8 lo[3], hi[3];
+    for (size_t j = 0; j < k; ++j) {
+        lo[j] = hn::LoadDup128(_du8, plan.masks + j * 32);
+        hi[j] = hn::LoadDup128(_du8, plan.masks + j * 32 + 16);
+    }
+    auto buckets = [&](size_t j, vu8 v) {
+        return hn::And(hn::TableLookupBytes(lo[j], hn::And(v, low)),
+                       hn::TableLookupBytes(hi[j], hn::ShiftRight<4>(v)));
+    };
+
+    HWY_ALIGN uint8_t lanes[N8];
+    auto verify = [&](size_t idx, vu8 cand) -> bool {
+        hn::Store(cand, _du8, lanes);
+        uint8_t bytes[8] = {0};
+        hn::StoreMaskBits(_du8, hn::Ne(cand, zero), bytes);
+        uint64_t bits;
+        memcpy(&bits, bytes, sizeof(bits));
+        while (bits != 0) {
+            const size_t lane = hwy::Num0BitsBelowLS1Bit_Nonzero64(bits);
+            const size_t pos  = idx + lane;
+            for (uint32_t b = lanes[lane]; b != 0; b &= b - 1) {
+                const size_t bucket = hwy::Num0BitsBelowLS1Bit_Nonzero32(b);
+                for (uint32_t i = plan.bucket_begin[bucket]; i < plan.bucket_begin[bucket + 1];
+                     ++i) {
+                    const uint32_t id  = plan.ids[i];
+                    const uint32_t off = plan.offsets[id];
+                    const size_t len   = plan.offsets[id + 1] - off;
+                    if (len <= n - pos && memcmp(hay + pos, plan.bytes + off, len) == 0 &&
+                        !fn(ctx, id, pos)) {
+                        return false;
+                    }
+                }
+            }
+            bits &= bits - 1;
+        }
+        return true;
+    };
+
+    const size_t npos = n - k + 1;  // candidate positions
+    size_t idx        = 0;
+    for (; idx + N8 <= npos; idx += N8) {
+        auto cand = buckets(0, hn::LoadU(_du8, h + idx));
+        for (size_t j = 1; j < k; ++j) {
+            cand = hn::And(cand, buckets(j, hn::LoadU(_du8, h + idx + j)));
+        }
+        if (!hn::AllTrue(_du8, hn::Eq(cand, zero)) && !verify(idx, cand)) {
+            return false;
+        }
+    }
+    if (idx != npos) {
+        const size_t cnt = npos - idx;
+        auto cand        = buckets(0, hn::LoadN(_du8, h + idx, cnt));
+        for (size_t j = 1; j < k; ++j) {
+            cand = hn::And(cand, buckets(j, hn::LoadN(_du8, h + idx + j, cnt)));
+        }
+        return verify(idx, hn::IfThenElseZero(hn::FirstN(_du8, cnt), cand));
+    }
+    return true;
+}
+
+// XXH64-style rounds over 64-byte stripes folded to lower case, so the result
+// does not depend on the vector width.
+uint64_t StrIHash(const char* s, size_t len) {
+    static constexpr uint64_t P1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64_t P3 = 0x165667B19E3779F9ull;
+    static constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr uint64_t P5 = 0x27D4EB2F165667C5ull;
+    static constexpr auto rotl   = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+    static constexpr auto round  = [](uint64_t acc, uint64_t w) {
+        return rotl(acc + w * P2, 31) * P1;
+    };
+
+    Folder<true> fold;
+    const auto* src = (const uint8_t*)s;
+    HWY_ALIGN uint8_t stripe[64];
+    uint64_t acc[8];
+    for (size_t i = 0; i < 8; ++i) {
+        acc[i] = P1 * (i + 1);
+    }
+    auto mix = [&] {
+        for (size_t i = 0; i < 8; ++i) {
+            uint64_t w;
+            memcpy(&w, stripe + i * 8, 8);
+            acc[i] = round(acc[i], w);
+        }
+    };
+
+    size_t idx = 0;
+    for (; idx + 64 <= len; idx += 64) {
+        for (size_t j = 0; j < 64; j += N8) {
+            hn::Store(fold(hn::LoadU(_du8, src + idx + j)), _du8, stripe + j);
+        }
+        mix();
+    }
+    if (idx != len) {
+        for (size_t j = 0; j < 64; j += N8) {
+            const size_t n = idx + j < len ? HWY_MIN(N8, len - idx - j) : 0;
+            hn::Store(fold(hn::LoadN(_du8, src + idx + j, n)), _du8, stripe + j);
+        }
+        mix();
+    }
+
+    uint64_t h = P5 + len;
+    for (size_t i = 0; i < 8; ++i) {
+        h ^= round(0, acc[i]);
+        h = rotl(h, 27) * P1 + P4;
+    }
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+// Set membership by nibble lookups: the low nibble selects a row of the
+// charset table (bytes 0-15 for high nibbles 0-7, bytes 16-31 for 8-15) and
+// the high nibble selects a bit in it. Exact for any set of bytes.
+struct CharsetMatch {
+    const vu8 lo_rows;
+    const vu8 hi_rows;
+    const vu8 bits  = hn::Dup128VecFromValues(_du8, 1, 2, 4, 8, 16, 32, 64, 128,  //
+                                              1, 2, 4, 8, 16, 32, 64, 128);
+    const vu8 _0x0f = hn::Set(_du8, 0x0f);
+    const vu8 _8    = hn::Set(_du8, 8);
+
+    explicit CharsetMatch(const uint8_t* table)
+      : lo_rows(hn::LoadDup128(_du8, table)), hi_rows(hn::LoadDup128(_du8, table + 16)) {}
+
+    HWY_INLINE hn::Mask<decltype(_du8)> operator()(vu8 v) const {
+        const auto hi  = hn::ShiftRight<4>(v);
+        const auto lo  = hn::And(v, _0x0f);
+        const auto row = hn::IfThenElse(hn::Lt(hi, _8), hn::TableLookupBytes(lo_rows, lo),
+                                        hn::TableLookupBytes(hi_rows, lo));
+        return hn::TestBit(row, hn::TableLookupBytes(bits, hi));
+    }
+};
+
+template <bool kNot>
+HWY_INLINE size_t FindOfImpl(const char* s, size_t len, const uint8_t* table) {
+    const CharsetMatch match(table);
+    const auto* src = (const uint8_t*)s;
+    size_t idx      = 0;
+    for (; idx + N8 <= len; idx += N8) {
+        auto m = match(hn::LoadU(_du8, src + idx));
+        if constexpr (kNot) {
+            m = hn::Not(m);
+        }
+        const intptr_t k = hn::FindFirstTrue(_du8, m);
+        if (k >= 0) {
+            return idx + k;
+        }
+    }
+    if (idx != len) {
+        const size_t n = len - idx;
+        auto m         = match(hn::LoadN(_du8, src + idx, n));
+        if constexpr (kNot) {
+            m = hn::Not(m);
+        }
+        const intptr_t k = hn::FindFirstTrue(_du8, hn::And(m, hn::FirstN(_du8, n)));
+        if (k >= 0) {
+            return idx + k;
+        }
+    }
+    return std::string_view::npos;
+}
+
+size_t StrFindFirstOf(const char* s, size_t len, const uint8_t* table) {
+    return FindOfImpl<false>(s, len, table);
+}
+
+size_t StrFindFirstNotOf(const char* s, size_t len, const uint8_t* table) {
+    return FindOfImpl<true>(s, len, table);
+}
+
+// Keeps the bytes not in the set with CompressBlendedStore, which writes only
+// the kept lanes, so `out` may equal `in`. Returns the bytes written.
+size_t StrRemoveBytes(const char* in, size_t len, const uint8_t* table, char* out) {
+    const CharsetMatch match(table);
+    const auto* src = (const uint8_t*)in;
+    auto* dst       = (uint8_t*)out;
+    size_t written  = 0;
+    size_t idx      = 0;
+    for (; idx + N8 <= len; idx += N8) {
+        const auto v = hn::LoadU(_du8, src + idx);
+        written += hn::CompressBlendedStore(v, hn::Not(match(v)), _du8, dst + written);
+    }
+    if (idx != len) {
+        const size_t n = len - idx;
+        const auto v   = hn::LoadN(_du8, src + idx, n);
+        const auto m   = hn::AndNot(match(v), hn::FirstN(_du8, n));
+        written += hn::CompressBlendedStore(v, m, _du8, dst + written);
+    }
+    return written;
+}
+
+// ASCII whitespace as in the "C" locale: ' ', '\t', '\n', '\v', '\f', '\r'.
+struct SpaceMatch {
+    const vu8 _space = hn::Set(_du8, ' ');
+    const vu8 _9     = hn::Set(_du8, 9);
+    const vu8 _5     = hn::Set(_du8, 5);
+
+    HWY_INLINE hn::Mask<decltype(_du8)> operator()(vu8 v) const {
+        return hn::Or(hn::Eq(v, _space), hn::Lt(hn::Sub(v, _9), _5));
+    }
+};
+
+// Index of the first non-space byte, or len.
+size_t StrTrimLeft(const char* s, size_t len) {
+    const SpaceMatch space;
+    const auto* src = (const uint8_t*)s;
+    size_t idx      = 0;
+    for (; idx + N8 <= len; idx += N8) {
+        const intptr_t k = hn::FindFirstTrue(_du8, hn::Not(space(hn::LoadU(_du8, src + idx))));
+        if (k >= 0) {
+            return idx + k;
+        }
+    }
+    if (idx != len) {
+        const size_t n   = len - idx;
+        const auto m     = hn::AndNot(space(hn::LoadN(_du8, src + idx, n)), hn::FirstN(_du8, n));
+        const intptr_t k = hn::FindFirstTrue(_du8, m);
+        if (k >= 0) {
+            return idx + k;
+        }
+    }
+    return len;
+}
+
+// One past the last non-space byte, or 0. Scans backwards from the end.
+size_t StrTrimRight(const char* s, size_t len) {
+    const SpaceMatch space;
+    const auto* src = (const uint8_t*)s;
+    size_t end      = len;
+    for (; end >= N8; end -= N8) {
+        const auto m     = hn::Not(space(hn::LoadU(_du8, src + end - N8)));
+        const intptr_t k = hn::FindLastTrue(_du8, m);
+        if (k >= 0) {
+            return end - N8 + k + 1;
+        }
+    }
+    if (end != 0) {
+        const auto m     = hn::AndNot(space(hn::LoadN(_du8, src, end)), hn::FirstN(_du8, end));
+        const intptr_t k = hn::FindLastTrue(_du8, m);
+        if (k >= 0) {
+            return k + 1;
+        }
+    }
+    return 0;
+}
+
+// One pass: every delimiter in a vector is taken from its mask bits. With
+// kTrim the non-space bits of the same vector give each field's first and
+// last non-space byte, so the padding is dropped without a second scan.
+template <bool kTrim>
+HWY_INLINE void SplitAnyImpl(const char* s, size_t len, const uint8_t* table,
+                             std::vector<std::string_view>& out) {
+    const CharsetMatch match(table);
+    const SpaceMatch space;
+    const auto* src = (const uint8_t*)s;
+    size_t start    = 0;                       // current field
+    size_t first    = std::string_view::npos;  // its first non-space byte
+    size_t last     = 0;                       // one past its last non-space byte
+
+    auto to_bits = [](hn::Mask<decltype(_du8)> m) {
+        uint8_t bytes[8] = {0};
+        hn::StoreMaskBits(_du8, m, bytes);
+        uint64_t bits;
+        memcpy(&bits, bytes, sizeof(bits));
+        return bits;
+    };
+    // Non-space bytes of the vector at `idx` in [lo, hi).
+    auto solid = [&](size_t idx, uint64_t bits, size_t lo, size_t hi) {
+        if (lo >= hi) {
+            return;
+        }
+        const uint64_t below = hi - idx >= 64 ? ~0ull : (1ull << (hi - idx)) - 1;
+        bits &= below & ~((1ull << (lo - idx)) - 1);
+        if (bits != 0) {
+            if (first == std::string_view::npos) {
+                first = idx + hwy::Num0BitsBelowLS1Bit_Nonzero64(bits);
+            }
+            last = idx + 64 - hwy::Num0BitsAboveMS1Bit_Nonzero64(bits);
+        }
+    };
+    auto field = [&](size_t end) {
+        if constexpr (kTrim) {
+            if (first == std::string_view::npos) {
+                out.emplace_back(s + start, 0);
+            } else {
+                out.emplace_back(s + first, last - first);
+            }
+            first = std::string_view::npos;
+        } else {
+            out.emplace_back(s + start, end - start);
+        }
+        start = end + 1;
+    };
+    auto step = [&](size_t idx, size_t n, hn::Mask<decltype(_du8)> delims, vu8 v) {
+        uint64_t bits = to_bits(delims);
+        if constexpr (kTrim) {
+            const uint64_t ns = to_bits(hn::AndNot(space(v), hn::FirstN(_du8, n)));
+            while (bits != 0) {
+                const size_t pos = idx + hwy::Num0BitsBelowLS1Bit_Nonzero64(bits);
+                solid(idx, ns, HWY_MAX(start, idx), pos);
+                field(pos);
+                bits &= bits - 1;
+            }
+            solid(idx, ns, HWY_MAX(start, idx), idx + n);
+        } else {
+            (void)n;
+            (void)v;
+            while (bits != 0) {
+                field(idx + hwy::Num0BitsBelowLS1Bit_Nonzero64(bits));
+                bits &= bits - 1;
+            }
+        }
+    };
+
+    size_t idx = 0;
+    for (; idx + N8 <= len; idx += N8) {
+        const auto v = hn::LoadU(_du8, src + idx);
+        const auto m = match(v);
+        if (kTrim || !hn::AllFalse(_du8, m)) {
+            step(idx, N8, m, v);
+        }
+    }
+    if (idx != len) {
+        const size_t n = len - idx;
+        const auto v   = hn::LoadN(_du8, src + idx, n);
+        step(idx, n, hn::And(match(v), hn::FirstN(_du8, n)), v);
+    }
+    field(len);
+}
+
+void StrSplitAny(const char* s, size_t len, const uint8_t* table, bool trim,
+                 std::vector<std::string_view>& out) {
+    if (trim) {
+        SplitAnyImpl<true>(s, len, table, out);
+    } else {
+        SplitAnyImpl<false>(s, len, table, out);
+    }
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+
+namespace ss {
+
+namespace detail {
+
 inline int mcmp(const void* s1, const void* s2, size_t n) {
 #if HWY_COMPILER_MSVC
     return memcmp(s1, s2, n);
@@ -56,133 +725,462 @@ inline int mcmp(const void* s1, const void* s2, size_t n) {
 
 }  // namespace detail
 
-namespace {
-inline char toupper0(char c) {
-    return (c >= 'a' && c <= 'z') ? c - (char)32 : c;
+HWY_EXPORT(StrToUpper);
+HWY_EXPORT(StrToLower);
+
+std::string str_toupper(std::string_view s) {
+    std::string out(s.size(), '\0');
+    HWY_DYNAMIC_DISPATCH(StrToUpper)(s.data(), s.size(), out.data());
+    return out;
 }
 
-inline char tolower0(char c) {
-    return (c >= 'A' && c <= 'Z') ? c + (char)32 : c;
+std::string str_tolower(std::string_view s) {
+    std::string out(s.size(), '\0');
+    HWY_DYNAMIC_DISPATCH(StrToLower)(s.data(), s.size(), out.data());
+    return out;
 }
-}  // namespace
 
-std::string str_toupper(std::string_view s) {
-    size_t len = s.size();
-    std::string out(len, '\0');
-#if HWY_COMPILER_MSVC
-    size_t mod = len % N8;
-    if (len > mod) {
-        detail::UpperUnit upperfn;
-        hn::Unroller(upperfn, (uint8_t*)s.data(), (uint8_t*)out.data(), len - mod);
+size_t str_toupper(const char* s, size_t len, char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < len)) {
+        throw std::length_error("Output buffer too small");
     }
-    if (mod > 0) {
-        int start = len - mod;
-        std::transform(s.begin() + start, s.end(), out.data() + start, toupper0);
+    HWY_DYNAMIC_DISPATCH(StrToUpper)(s, len, out);
+    return len;
+}
+
+size_t str_tolower(const char* s, size_t len, char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < len)) {
+        throw std::length_error("Output buffer too small");
     }
-#else
-    std::transform(s.begin(), s.end(), out.data(), toupper0);
-#endif
+    HWY_DYNAMIC_DISPATCH(StrToLower)(s, len, out);
+    return len;
+}
+
+void str_toupper_inplace(std::string& s) {
+    HWY_DYNAMIC_DISPATCH(StrToUpper)(s.data(), s.size(), s.data());
+}
+
+void str_tolower_inplace(std::string& s) {
+    HWY_DYNAMIC_DISPATCH(StrToLower)(s.data(), s.size(), s.data());
+}
+
+HWY_EXPORT(StrReplaceByte);
+HWY_EXPORT(StrTranslate);
+HWY_EXPORT(StrRemoveBytes);
+
+std::string str_replace_byte(std::string_view s, char from, char to) {
+    std::string out(s.size(), '\0');
+    HWY_DYNAMIC_DISPATCH(StrReplaceByte)(s.data(), s.size(), from, to, out.data());
     return out;
 }
 
-std::string str_tolower(std::string_view s) {
-    size_t len = s.size();
-    std::string out(len, '\0');
-#if HWY_COMPILER_MSVC
-    size_t mod = len % N8;
-    if (len > mod) {
-        detail::LowerUnit lowerfn;
-        hn::Unroller(lowerfn, (uint8_t*)s.data(), (uint8_t*)out.data(), len - mod);
+void str_replace_byte_inplace(std::string& s, char from, char to) {
+    HWY_DYNAMIC_DISPATCH(StrReplaceByte)(s.data(), s.size(), from, to, s.data());
+}
+
+std::string str_translate(std::string_view s, const uint8_t table[256]) {
+    std::string out(s.size(), '\0');
+    HWY_DYNAMIC_DISPATCH(StrTranslate)(s.data(), s.size(), table, out.data());
+    return out;
+}
+
+void str_translate_inplace(std::string& s, const uint8_t table[256]) {
+    HWY_DYNAMIC_DISPATCH(StrTranslate)(s.data(), s.size(), table, s.data());
+}
+
+std::string str_remove_bytes(std::string_view s, const charset& set) {
+    std::string out(s.size(), '\0');
+    out.resize(HWY_DYNAMIC_DISPATCH(StrRemoveBytes)(s.data(), s.size(), set.table(), out.data()));
+    return out;
+}
+
+size_t str_remove_bytes(const char* s, size_t len, const charset& set, char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < len)) {
+        throw std::length_error("Output buffer too small");
     }
-    if (mod > 0) {
-        int start = len - mod;
-        std::transform(s.begin() + start, s.end(), out.data() + start, tolower0);
+    return HWY_DYNAMIC_DISPATCH(StrRemoveBytes)(s, len, set.table(), out);
+}
+
+size_t str_replace_all(std::string_view s, const searcher& needle, std::string_view repl,
+                       std::string& out) {
+    const size_t m = needle.needle().size();
+    if (m == 0) {
+        out.append(s);
+        return s.size();
     }
-#else
-    std::transform(s.begin(), s.end(), out.data(), tolower0);
-#endif
+    // One scan for every match, the buffer keeps its capacity across calls.
+    thread_local std::vector<size_t> hits;
+    const size_t count = needle.find_all(s, hits);
+    const size_t n     = s.size() - count * m + count * repl.size();
+    const size_t old   = out.size();
+    out.resize(old + n);
+    char* p    = out.data() + old;
+    size_t pos = 0;
+    for (const size_t hit : hits) {
+        hwy::CopyBytes(s.data() + pos, p, hit - pos);
+        p += hit - pos;
+        hwy::CopyBytes(repl.data(), p, repl.size());
+        p += repl.size();
+        pos = hit + m;
+    }
+    hwy::CopyBytes(s.data() + pos, p, s.size() - pos);
+    return n;
+}
+
+size_t str_replace_all(std::string_view s, std::string_view needle, std::string_view repl,
+                       std::string& out) {
+    return str_replace_all(s, searcher(needle), repl, out);
+}
+
+std::string str_replace_all(std::string_view s, const searcher& needle, std::string_view repl) {
+    std::string out;
+    str_replace_all(s, needle, repl, out);
     return out;
 }
 
-std::vector<std::string_view>  //
-str_split(std::string_view str, std::string_view delimiter, bool trim) {
-#if LC_HAS_MEMMEM
-    size_t start       = 0;
-    size_t end         = 0;
-    size_t dlen        = delimiter.size();
-    size_t slen        = str.size();
-    const char* ps     = str.data();
-    const char* ps_end = ps + slen;
-    const char* pd     = delimiter.data();
-    std::vector<std::string_view> result;
-    result.reserve(16);
+std::string str_replace_all(std::string_view s, std::string_view needle, std::string_view repl) {
+    return str_replace_all(s, searcher(needle), repl);
+}
+
+HWY_EXPORT(StrIEquals);
+HWY_EXPORT(StrFind);
+HWY_EXPORT(StrIFind);
+HWY_EXPORT(StrIHash);
 
-    for (;;) {
-        auto p = (const char*)memmem(ps, ps_end - ps, pd, dlen);
-        if (!p) {
-            result.emplace_back(std::string_view(ps, ps_end - ps));
-            break;
+bool str_iequals(std::string_view a, std::string_view b) {
+    const size_t len = a.size();
+    return len == b.size() && HWY_DYNAMIC_DISPATCH(StrIEquals)(a.data(), b.data(), len);
+}
+
+bool str_istarts_with(std::string_view s, std::string_view prefix) {
+    const size_t plen = prefix.size();
+    return s.size() >= plen && HWY_DYNAMIC_DISPATCH(StrIEquals)(s.data(), prefix.data(), plen);
+}
+
+bool str_iends_with(std::string_view s, std::string_view suffix) {
+    const size_t slen = s.size();
+    const size_t plen = suffix.size();
+    return slen >= plen &&
+           HWY_DYNAMIC_DISPATCH(StrIEquals)(s.data() + slen - plen, suffix.data(), plen);
+}
+
+size_t str_ifind(std::string_view s, std::string_view needle, size_t pos) {
+    if (pos > s.size() || needle.size() > s.size() - pos) {
+        return std::string_view::npos;
+    }
+    if (needle.empty()) {
+        return pos;
+    }
+    const char* p  = s.data() + pos;
+    const size_t n = s.size() - pos;
+    const size_t r = HWY_DYNAMIC_DISPATCH(StrIFind)(p, n, needle.data(), needle.size());
+    return r == std::string_view::npos ? r : r + pos;
+}
+
+size_t str_find(std::string_view s, std::string_view needle, size_t pos) {
+    if (pos > s.size() || needle.size() > s.size() - pos) {
+        return std::string_view::npos;
+    }
+    if (needle.empty()) {
+        return pos;
+    }
+    const char* p  = s.data() + pos;
+    const size_t n = s.size() - pos;
+    const size_t r = HWY_DYNAMIC_DISPATCH(StrFind)(p, n, needle.data(), needle.size());
+    return r == std::string_view::npos ? r : r + pos;
+}
+
+uint64_t str_ihash(std::string_view s) {
+    return HWY_DYNAMIC_DISPATCH(StrIHash)(s.data(), s.size());
+}
+
+searcher::searcher(std::string_view needle) : needle_(needle) {
+    const size_t m = needle_.size();
+    if (m >= kRaitaMin) {
+        const auto shift = (uint32_t)HWY_MIN(m, (size_t)UINT32_MAX);
+        skip_.assign(256, shift);
+        for (size_t j = 0; j + 1 < m; ++j) {
+            skip_[(uint8_t)needle_[j]] = (uint32_t)HWY_MIN(m - 1 - j, (size_t)shift);
         }
-        result.emplace_back(std::string_view(ps, p - ps));
-        ps = p + dlen;
     }
+}
 
-    return result;
-#else
-    size_t start = 0;
-    size_t end   = 0;
-    size_t dlen  = delimiter.size();
-    std::vector<std::string_view> result;
-    result.reserve(16);
+HWY_EXPORT(SearcherFind);
+HWY_EXPORT(SearcherRFind);
+HWY_EXPORT(SearcherCount);
+HWY_EXPORT(SearcherFindAll);
+
+size_t searcher::find(std::string_view hay, size_t pos) const {
+    const size_t m = needle_.size();
+    if (pos > hay.size() || m > hay.size() - pos) {
+        return std::string_view::npos;
+    }
+    if (m == 0) {
+        return pos;
+    }
+    const char* p  = hay.data() + pos;
+    const size_t n = hay.size() - pos;
+    const size_t r = HWY_DYNAMIC_DISPATCH(SearcherFind)(p, n, needle_.data(), m, skip());
+    return r == std::string_view::npos ? r : r + pos;
+}
+
+size_t searcher::rfind(std::string_view hay, size_t pos) const {
+    const size_t m = needle_.size();
+    if (m > hay.size()) {
+        return std::string_view::npos;
+    }
+    const size_t start = HWY_MIN(pos, hay.size() - m);
+    if (m == 0) {
+        return start;
+    }
+    return HWY_DYNAMIC_DISPATCH(SearcherRFind)(hay.data(), start + m, needle_.data(), m);
+}
+
+size_t searcher::count(std::string_view hay) const {
+    const size_t m = needle_.size();
+    if (m == 0) {
+        return hay.size() + 1;
+    }
+    if (m > hay.size()) {
+        return 0;
+    }
+    return HWY_DYNAMIC_DISPATCH(SearcherCount)(hay.data(), hay.size(), needle_.data(), m, skip());
+}
+
+size_t searcher::find_all(std::string_view hay, std::vector<size_t>& out) const {
+    const size_t m = needle_.size();
+    out.clear();
+    if (m == 0) {
+        for (size_t i = 0; i <= hay.size(); ++i) {
+            out.push_back(i);
+        }
+    } else if (m <= hay.size()) {
+        HWY_DYNAMIC_DISPATCH(SearcherFindAll)
+        (hay.data(), hay.size(), needle_.data(), m, skip(), out);
+    }
+    return out.size();
+}
 
-    while ((end = str.find(delimiter, start)) != std::string_view::npos) {
-        auto s = str.substr(start, end - start);
-        result.emplace_back(trim ? str_trim(s) : s);
-        start = end + dlen;
+charset::charset(std::string_view chars) {
+    for (unsigned char c : chars) {
+        table_[(c & 0x0f) | (c >> 7 << 4)] |= (uint8_t)(1u << (c >> 4 & 7));
     }
-    auto s = str.substr(start);
-    result.emplace_back(trim ? str_trim(s) : s);
+}
+
+HWY_EXPORT(StrFindFirstOf);
+HWY_EXPORT(StrFindFirstNotOf);
+HWY_EXPORT(StrSplitAny);
+
+size_t str_find_first_of(std::string_view s, const charset& set, size_t pos) {
+    if (pos >= s.size()) {
+        return std::string_view::npos;
+    }
+    const size_t n = s.size() - pos;
+    const size_t r = HWY_DYNAMIC_DISPATCH(StrFindFirstOf)(s.data() + pos, n, set.table());
+    return r == std::string_view::npos ? r : r + pos;
+}
+
+size_t str_find_first_not_of(std::string_view s, const charset& set, size_t pos) {
+    if (pos >= s.size()) {
+        return std::string_view::npos;
+    }
+    const size_t n = s.size() - pos;
+    const size_t r = HWY_DYNAMIC_DISPATCH(StrFindFirstNotOf)(s.data() + pos, n, set.table());
+    return r == std::string_view::npos ? r : r + pos;
+}
+
+size_t str_span(std::string_view s, const charset& set) {
+    const size_t r = str_find_first_not_of(s, set);
+    return r == std::string_view::npos ? s.size() : r;
+}
+
+size_t str_split_any_into(std::string_view str, const charset& delimiters,
+                          std::vector<std::string_view>& out, bool trim) {
+    out.clear();
+    HWY_DYNAMIC_DISPATCH(StrSplitAny)(str.data(), str.size(), delimiters.table(), trim, out);
+    return out.size();
+}
+
+std::vector<std::string_view>  //
+str_split_any(std::string_view str, const charset& delimiters, bool trim) {
+    std::vector<std::string_view> result;
+    str_split_any_into(str, delimiters, result, trim);
     return result;
-#endif
 }
 
-std::string str_join(const std::vector<std::string_view>& vs, std::string_view delimiter) {
-    int count      = 0;
-    size_t dlen    = delimiter.size();
-    const char* pd = delimiter.data();
-    for (const auto& s : vs) {
-        count += s.size();
+multi_searcher::multi_searcher(const std::vector<std::string_view>& patterns) {
+    const size_t count = patterns.size();
+    size_t min_len     = SIZE_MAX;
+    offsets_.push_back(0);
+    for (auto p : patterns) {
+        if (p.empty()) {
+            throw std::runtime_error("Empty pattern");
+        }
+        bytes_.append(p);
+        offsets_.push_back((uint32_t)bytes_.size());
+        min_len = HWY_MIN(min_len, p.size());
+    }
+
+    if (count <= kTeddyMax) {
+        // Sorted, so patterns sharing leading bytes share a bucket.
+        k_ = HWY_MIN(min_len, (size_t)3);
+        ids_.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            ids_[i] = i;
+        }
+        std::sort(ids_.begin(), ids_.end(),
+                  [&](uint32_t a, uint32_t b) { return pattern(a) < pattern(b); });
+        const size_t per = (count + 7) / 8;
+        for (size_t b = 0; b <= 8; ++b) {
+            bucket_begin_[b] = (uint32_t)HWY_MIN(b * per, count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t bit = (uint8_t)(1u << (i / per));
+            const auto p      = pattern(ids_[i]);
+            for (size_t j = 0; j < k_; ++j) {
+                const auto c = (uint8_t)p[j];
+                masks_[j * 32 + (c & 0x0f)] |= bit;
+                masks_[j * 32 + 16 + (c >> 4)] |= bit;
+            }
+        }
+        return;
+    }
+
+    // Bytes absent from every pattern share class 0, which always leads to the root.
+    for (unsigned char c : bytes_) {
+        classes_[c] = 1;
     }
-    count += dlen * (vs.size() - 1);
+    for (size_t c = 0; c < 256; ++c) {
+        classes_[c] = classes_[c] ? (uint8_t)++nclasses_ : 0;
+    }
+    ++nclasses_;
 
-    std::string out(count, '\0');
-    char* pout = out.data();
-    bool first = true;
-    for (const auto& s : vs) {
-        if (!first) {
-            hwy::CopyBytes(pd, pout, dlen);
-            pout += dlen;
+    // trie
+    delta_.assign(nclasses_, 0);
+    term_.assign(1, -1);
+    dup_.assign(count, -1);
+    for (uint32_t id = 0; id < count; ++id) {
+        uint32_t s = 0;
+        for (unsigned char c : pattern(id)) {
+            uint32_t& next = delta_[s * nclasses_ + classes_[c]];
+            if (next == 0) {
+                next = (uint32_t)term_.size();
+                term_.push_back(-1);
+                delta_.resize(delta_.size() + nclasses_, 0);
+            }
+            s = delta_[s * nclasses_ + classes_[c]];
+        }
+        dup_[id] = term_[s];
+        term_[s] = (int32_t)id;
+    }
+
+    // Breadth first, so fail[] of shallower states is final when read. Missing
+    // edges are filled from the fail state, turning the trie into a DFA.
+    const size_t states = term_.size();
+    std::vector<uint32_t> fail(states, 0), queue;
+    dict_.assign(states, 0);
+    queue.reserve(states);
+    for (size_t c = 0; c < nclasses_; ++c) {
+        if (delta_[c] != 0) {
+            queue.push_back(delta_[c]);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t s = queue[head];
+        for (size_t c = 0; c < nclasses_; ++c) {
+            uint32_t& next     = delta_[s * nclasses_ + c];
+            const uint32_t alt = delta_[fail[s] * nclasses_ + c];
+            if (next == 0) {
+                next = alt;
+            } else {
+                fail[next]  = alt;
+                dict_[next] = term_[alt] != -1 ? alt : dict_[alt];
+                queue.push_back(next);
+            }
         }
-        first      = false;
-        size_t len = s.size();
-        hwy::CopyBytes(s.data(), pout, len);
-        pout += len;
     }
-    return out;
 }
 
-std::string_view str_trim(std::string_view str) {
-    size_t start = 0;
-    while (start < str.size() && std::isspace(static_cast<unsigned char>(str[start]))) {
-        ++start;
+HWY_EXPORT(MultiTeddy);
+
+bool multi_searcher::scan(std::string_view hay, detail::match_fn fn, void* ctx) const {
+    if (!ids_.empty()) {
+        const detail::teddy_plan plan = {masks_,          k_,          bytes_.data(),
+                                         offsets_.data(), ids_.data(), bucket_begin_};
+        return HWY_DYNAMIC_DISPATCH(MultiTeddy)(hay.data(), hay.size(), plan, fn, ctx);
+    }
+    if (delta_.empty()) {
+        return true;  // no patterns
+    }
+    const auto* h = (const uint8_t*)hay.data();
+    uint32_t s    = 0;
+    for (size_t i = 0; i < hay.size(); ++i) {
+        s = delta_[s * nclasses_ + classes_[h[i]]];
+        for (uint32_t t = term_[s] != -1 ? s : dict_[s]; t != 0; t = dict_[t]) {
+            for (int32_t id = term_[t]; id != -1; id = dup_[id]) {
+                const size_t len = offsets_[id + 1] - offsets_[id];
+                if (!fn(ctx, id, i + 1 - len)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void split_view::iterator::next() {
+    if (next_ == std::string_view::npos) {
+        pos_ = std::string_view::npos;
+        return;
+    }
+    const auto& s  = view_->str_;
+    const auto& d  = view_->delimiter_;
+    pos_           = next_;
+    const size_t e = d.empty() ? std::string_view::npos : str_find(s, d, pos_);
+    if (e == std::string_view::npos) {
+        field_ = s.substr(pos_);
+        next_  = std::string_view::npos;
+    } else {
+        field_ = s.substr(pos_, e - pos_);
+        next_  = e + d.size();
+    }
+    if (view_->trim_) {
+        field_ = str_trim(field_);
     }
+}
 
-    size_t end = str.size();
-    while (end > start && std::isspace(static_cast<unsigned char>(str[end - 1]))) {
-        --end;
+size_t str_split_into(std::string_view str, std::string_view delimiter,
+                      std::vector<std::string_view>& out, bool trim) {
+    if (delimiter.size() == 1) {
+        return str_split_any_into(str, charset(delimiter), out, trim);
+    }
+    out.clear();
+    for (auto field : split_view(str, delimiter, trim)) {
+        out.emplace_back(field);
     }
+    return out.size();
+}
 
-    return str.substr(start, end - start);
+std::vector<std::string_view>  //
+str_split(std::string_view str, std::string_view delimiter, bool trim) {
+    std::vector<std::string_view> result;
+    str_split_into(str, delimiter, result, trim);
+    return result;
+}
+
+HWY_EXPORT(StrTrimLeft);
+HWY_EXPORT(StrTrimRight);
+
+std::string_view str_ltrim(std::string_view str) {
+    return str.substr(HWY_DYNAMIC_DISPATCH(StrTrimLeft)(str.data(), str.size()));
+}
+
+std::string_view str_rtrim(std::string_view str) {
+    return str.substr(0, HWY_DYNAMIC_DISPATCH(StrTrimRight)(str.data(), str.size()));
+}
+
+std::string_view str_trim(std::string_view str) {
+    return str_rtrim(str_ltrim(str));
 }
 
 bool str_starts_with(std::string_view s, std::string_view prefix) {
@@ -198,3 +1196,5 @@ bool str_ends_with(std::string_view s, std::string_view prefix) {
 }
 
 }  // namespace ss
+
+#endif  // HWY_ONCE
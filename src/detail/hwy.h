@@ -1,7 +1,18 @@
-#pragma once
-
-#include <hwy/highway.h>
-#include <stdint.h>
+// Per-target include guard: this header is re-included once per target by
+// hwy/foreach_target.h, so it must not use `#pragma once`.
+#if defined(STRINGS_DETAIL_HWY_H_) == defined(HWY_TARGET_TOGGLE)
+#    ifdef STRINGS_DETAIL_HWY_H_
+#        undef STRINGS_DETAIL_HWY_H_
+#    else
+#        define STRINGS_DETAIL_HWY_H_
+#    endif
+
+#    include <hwy/highway.h>
+#    include <stdint.h>
+
+HWY_BEFORE_NAMESPACE();
+namespace ss {
+namespace HWY_NAMESPACE {
 
 namespace hn = hwy::HWY_NAMESPACE;
 
@@ -14,6 +25,7 @@ using i32 = int32_t;
 
 using vu8  = hn::Vec<HWY_FULL(u8)>;
 using vu16 = hn::Vec<HWY_FULL(u16)>;
+using vu32 = hn::Vec<HWY_FULL(u32)>;
 
 static constexpr HWY_FULL(u8) _du8{};
 static constexpr HWY_FULL(u16) _du16{};
@@ -26,7 +38,7 @@ static constexpr size_t N8  = hn::Lanes(_du8);
 static constexpr size_t N16 = hn::Lanes(_du16);
 static constexpr size_t N32 = hn::Lanes(_du32);
 
-#define HWY_CLAMP(x, min, max) (HWY_MAX(HWY_MIN((x), (max)), (min)))
+#    define HWY_CLAMP(x, min, max) (HWY_MAX(HWY_MIN((x), (max)), (min)))
 
 template <typename D>
 struct hwy_tag_inner;
@@ -77,3 +89,9 @@ template <typename V>
 V IfThenZeroElse(const V mask, const V no) {
     return hn::AndNot(mask, no);
 }
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#endif  // STRINGS_DETAIL_HWY_H_
@@ -0,0 +1,276 @@
+#include "strings/md5.h"
+#include "strings/sha1.h"
+#include <string.h>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "src/hash_many.cpp"
+#include <hwy/foreach_target.h>  // IWYU pragma: keep
+
+#include "detail/hwy.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace ss {
+namespace HWY_NAMESPACE {
+
+namespace {
+
+// One message per u32 lane. Each lane walks the padded blocks of its own
+// message; lanes whose message has already ended keep their state.
+template <bool BigEndian>
+struct LaneBlocks {
+    const std::string_view* _msgs;
+    size_t _count;                    // <= N32
+    HWY_ALIGN u32 _nblocks[N32] = {0};
+    HWY_ALIGN u8 _tails[N32][128];    // last one or two blocks, padded
+    size_t _tail_start[N32];
+    size_t _max_blocks = 0;
+
+    LaneBlocks(const std::string_view* msgs, size_t count) : _msgs(msgs), _count(count) {
+        for (size_t i = 0; i < count; ++i) {
+            const size_t len   = msgs[i].size();
+            const size_t start = len & ~(size_t)63;
+            const size_t rest  = len - start;
+            const size_t total = (rest < 56) ? 64 : 128;
+            const uint64_t bits = (uint64_t)len << 3;
+            memcpy(_tails[i], msgs[i].data() + start, rest);
+            _tails[i][rest] = 0x80;
+            memset(_tails[i] + rest + 1, 0, total - rest - 1);
+            for (int k = 0; k < 8; ++k) {
+                _tails[i][total - 8 + k] = (u8)(bits >> (BigEndian ? 56 - 8 * k : 8 * k));
+            }
+            _tail_start[i] = start;
+            _nblocks[i]    = (u32)((start + total) / 64);
+            _max_blocks    = HWY_MAX(_max_blocks, (size_t)_nblocks[i]);
+        }
+    }
+
+    // transpose block `b` of every lane into 16 vectors of message words
+    void Load(size_t b, vu32* w) const {
+        HWY_ALIGN u32 words[16 * N32] = {0};
+        for (size_t i = 0; i < _count; ++i) {
+            if (b >= _nblocks[i]) continue;
+            const size_t ofs = b * 64;
+            const u8* p      = (ofs < _tail_start[i]) ? (const u8*)_msgs[i].data() + ofs
+                                                      : _tails[i] + (ofs - _tail_start[i]);
+            for (size_t j = 0; j < 16; ++j, p += 4) {
+                words[j * N32 + i] =
+                    BigEndian ? (u32)p[0] << 24 | (u32)p[1] << 16 | (u32)p[2] << 8 | p[3]
+                              : (u32)p[3] << 24 | (u32)p[2] << 16 | (u32)p[1] << 8 | p[0];
+            }
+        }
+        for (size_t j = 0; j < 16; ++j) {
+            w[j] = hn::Load(_du32, words + j * N32);
+        }
+    }
+
+    hn::Mask<HWY_FULL(u32)> Active(size_t b) const {
+        return hn::Lt(hn::Set(_du32, (u32)b), hn::Load(_du32, _nblocks));
+    }
+};
+
+template <int S>
+HWY_INLINE vu32 RotateLeft(const vu32 x) {
+    return hn::RotateRight<32 - S>(x);
+}
+
+// clang-format off
+HWY_ALIGN static constexpr u32 _md5_t[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+// clang-format on
+
+HWY_INLINE vu32 Md5F(vu32 x, vu32 y, vu32 z) { return hn::Or(hn::And(x, y), hn::AndNot(x, z)); }
+HWY_INLINE vu32 Md5G(vu32 x, vu32 y, vu32 z) { return hn::Or(hn::And(x, z), hn::AndNot(z, y)); }
+HWY_INLINE vu32 Md5H(vu32 x, vu32 y, vu32 z) { return hn::Xor(hn::Xor(x, y), z); }
+HWY_INLINE vu32 Md5I(vu32 x, vu32 y, vu32 z) { return hn::Xor(y, hn::Or(x, hn::Not(z))); }
+
+template <int S>
+HWY_INLINE vu32 Md5Step(vu32 a, vu32 b, vu32 f, vu32 m, u32 t) {
+    const auto sum = hn::Add(hn::Add(a, f), hn::Add(m, hn::Set(_du32, t)));
+    return hn::Add(b, RotateLeft<S>(sum));
+}
+
+#define MD5_ROUND4(F, i, g0, g1, g2, g3, s0, s1, s2, s3)          \
+    a = Md5Step<s0>(a, b, F(b, c, d), w[g0], _md5_t[(i) + 0]); \
+    d = Md5Step<s1>(d, a, F(a, b, c), w[g1], _md5_t[(i) + 1]); \
+    c = Md5Step<s2>(c, d, F(d, a, b), w[g2], _md5_t[(i) + 2]); \
+    b = Md5Step<s3>(b, c, F(c, d, a), w[g3], _md5_t[(i) + 3]);
+
+void Md5Lanes(const std::string_view* msgs, size_t count, char* out) {
+    const LaneBlocks<false> blocks(msgs, count);
+    vu32 s0 = hn::Set(_du32, 0x67452301);
+    vu32 s1 = hn::Set(_du32, 0xEFCDAB89);
+    vu32 s2 = hn::Set(_du32, 0x98BADCFE);
+    vu32 s3 = hn::Set(_du32, 0x10325476);
+    vu32 w[16];
+
+    for (size_t blk = 0; blk < blocks._max_blocks; ++blk) {
+        blocks.Load(blk, w);
+        vu32 a = s0, b = s1, c = s2, d = s3;
+
+        MD5_ROUND4(Md5F, 0, 0, 1, 2, 3, 7, 12, 17, 22);
+        MD5_ROUND4(Md5F, 4, 4, 5, 6, 7, 7, 12, 17, 22);
+        MD5_ROUND4(Md5F, 8, 8, 9, 10, 11, 7, 12, 17, 22);
+        MD5_ROUND4(Md5F, 12, 12, 13, 14, 15, 7, 12, 17, 22);
+        MD5_ROUND4(Md5G, 16, 1, 6, 11, 0, 5, 9, 14, 20);
+        MD5_ROUND4(Md5G, 20, 5, 10, 15, 4, 5, 9, 14, 20);
+        MD5_ROUND4(Md5G, 24, 9, 14, 3, 8, 5, 9, 14, 20);
+        MD5_ROUND4(Md5G, 28, 13, 2, 7, 12, 5, 9, 14, 20);
+        MD5_ROUND4(Md5H, 32, 5, 8, 11, 14, 4, 11, 16, 23);
+        MD5_ROUND4(Md5H, 36, 1, 4, 7, 10, 4, 11, 16, 23);
+        MD5_ROUND4(Md5H, 40, 13, 0, 3, 6, 4, 11, 16, 23);
+        MD5_ROUND4(Md5H, 44, 9, 12, 15, 2, 4, 11, 16, 23);
+        MD5_ROUND4(Md5I, 48, 0, 7, 14, 5, 6, 10, 15, 21);
+        MD5_ROUND4(Md5I, 52, 12, 3, 10, 1, 6, 10, 15, 21);
+        MD5_ROUND4(Md5I, 56, 8, 15, 6, 13, 6, 10, 15, 21);
+        MD5_ROUND4(Md5I, 60, 4, 11, 2, 9, 6, 10, 15, 21);
+
+        const auto active = blocks.Active(blk);
+        s0                = hn::IfThenElse(active, hn::Add(s0, a), s0);
+        s1                = hn::IfThenElse(active, hn::Add(s1, b), s1);
+        s2                = hn::IfThenElse(active, hn::Add(s2, c), s2);
+        s3                = hn::IfThenElse(active, hn::Add(s3, d), s3);
+    }
+
+    HWY_ALIGN u32 state[4][N32];
+    hn::Store(s0, _du32, state[0]);
+    hn::Store(s1, _du32, state[1]);
+    hn::Store(s2, _du32, state[2]);
+    hn::Store(s3, _du32, state[3]);
+    for (size_t i = 0; i < count; ++i, out += md5_digest_size) {
+        for (size_t j = 0; j < 4; ++j) {
+            const u32 v = state[j][i];
+            out[j * 4 + 0] = (char)v;
+            out[j * 4 + 1] = (char)(v >> 8);
+            out[j * 4 + 2] = (char)(v >> 16);
+            out[j * 4 + 3] = (char)(v >> 24);
+        }
+    }
+}
+
+#undef MD5_ROUND4
+
+void Sha1Lanes(const std::string_view* msgs, size_t count, char* out) {
+    const LaneBlocks<true> blocks(msgs, count);
+    vu32 s0 = hn::Set(_du32, 0x67452301);
+    vu32 s1 = hn::Set(_du32, 0xEFCDAB89);
+    vu32 s2 = hn::Set(_du32, 0x98BADCFE);
+    vu32 s3 = hn::Set(_du32, 0x10325476);
+    vu32 s4 = hn::Set(_du32, 0xC3D2E1F0);
+    vu32 w[16];
+
+    for (size_t blk = 0; blk < blocks._max_blocks; ++blk) {
+        blocks.Load(blk, w);
+        vu32 a = s0, b = s1, c = s2, d = s3, e = s4;
+
+        const auto step = [&](size_t t, vu32 f, u32 k) {
+            if (t >= 16) {
+                const auto x = hn::Xor(hn::Xor(w[(t - 3) & 15], w[(t - 8) & 15]),
+                                       hn::Xor(w[(t - 14) & 15], w[t & 15]));
+                w[t & 15] = RotateLeft<1>(x);
+            }
+            const auto tmp = hn::Add(hn::Add(RotateLeft<5>(a), f),
+                                     hn::Add(hn::Add(e, hn::Set(_du32, k)), w[t & 15]));
+            e = d;
+            d = c;
+            c = RotateLeft<30>(b);
+            b = a;
+            a = tmp;
+        };
+        for (size_t t = 0; t < 20; ++t) {
+            step(t, hn::Or(hn::And(b, c), hn::AndNot(b, d)), 0x5A827999);
+        }
+        for (size_t t = 20; t < 40; ++t) {
+            step(t, hn::Xor(hn::Xor(b, c), d), 0x6ED9EBA1);
+        }
+        for (size_t t = 40; t < 60; ++t) {
+            step(t, hn::Or(hn::And(b, c), hn::And(hn::Or(b, c), d)), 0x8F1BBCDC);
+        }
+        for (size_t t = 60; t < 80; ++t) {
+            step(t, hn::Xor(hn::Xor(b, c), d), 0xCA62C1D6);
+        }
+
+        const auto active = blocks.Active(blk);
+        s0                = hn::IfThenElse(active, hn::Add(s0, a), s0);
+        s1                = hn::IfThenElse(active, hn::Add(s1, b), s1);
+        s2                = hn::IfThenElse(active, hn::Add(s2, c), s2);
+        s3                = hn::IfThenElse(active, hn::Add(s3, d), s3);
+        s4                = hn::IfThenElse(active, hn::Add(s4, e), s4);
+    }
+
+    HWY_ALIGN u32 state[5][N32];
+    hn::Store(s0, _du32, state[0]);
+    hn::Store(s1, _du32, state[1]);
+    hn::Store(s2, _du32, state[2]);
+    hn::Store(s3, _du32, state[3]);
+    hn::Store(s4, _du32, state[4]);
+    for (size_t i = 0; i < count; ++i, out += sha1_digest_size) {
+        for (size_t j = 0; j < 5; ++j) {
+            const u32 v = state[j][i];
+            out[j * 4 + 0] = (char)(v >> 24);
+            out[j * 4 + 1] = (char)(v >> 16);
+            out[j * 4 + 2] = (char)(v >> 8);
+            out[j * 4 + 3] = (char)v;
+        }
+    }
+}
+
+}  // namespace
+
+void Md5Many(const std::string_view* msgs, size_t count, char* out) {
+    for (size_t i = 0; i < count; i += N32) {
+        const size_t n = HWY_MIN(N32, count - i);
+        Md5Lanes(msgs + i, n, out + i * md5_digest_size);
+    }
+}
+
+void Sha1Many(const std::string_view* msgs, size_t count, char* out) {
+    for (size_t i = 0; i < count; i += N32) {
+        const size_t n = HWY_MIN(N32, count - i);
+        Sha1Lanes(msgs + i, n, out + i * sha1_digest_size);
+    }
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+
+namespace ss {
+
+HWY_EXPORT(Md5Many);
+HWY_EXPORT(Sha1Many);
+
+void md5_many(const std::string_view* msgs, size_t count, char* out) {
+    HWY_DYNAMIC_DISPATCH(Md5Many)(msgs, count, out);
+}
+
+void sha1_many(const std::string_view* msgs, size_t count, char* out) {
+    HWY_DYNAMIC_DISPATCH(Sha1Many)(msgs, count, out);
+}
+
+size_t md5_many(const std::vector<std::string_view>& msgs, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + msgs.size() * md5_digest_size);
+    md5_many(msgs.data(), msgs.size(), &out[pos]);
+    return msgs.size() * md5_digest_size;
+}
+
+size_t sha1_many(const std::vector<std::string_view>& msgs, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + msgs.size() * sha1_digest_size);
+    sha1_many(msgs.data(), msgs.size(), &out[pos]);
+    return msgs.size() * sha1_digest_size;
+}
+
+}  // namespace ss
+
+#endif  // HWY_ONCE
@@ -1,112 +1,108 @@
-#include "detail/hwy.h"
 #include "strings/hex.h"
 #include <stdexcept>
 #include <string>
-#include <hwy/contrib/unroller/unroller-inl.h>
 #include <string.h>
 
-namespace unsimd {
-
-#define HEX(v, c)                              \
-    {                                          \
-        char tmp = (char)c;                    \
-        if (tmp >= '0' && tmp <= '9') {        \
-            v = tmp - '0';                     \
-        } else if (tmp >= 'A' && tmp <= 'F') { \
-            v = tmp - 'A' + 10;                \
-        } else {                               \
-            v = tmp - 'a' + 10;                \
-        }                                      \
-    }
-
-void hex__marshal(const char* in, size_t insize, char* out) {
-    static char _hex[]  = "0123456789abcdef";
-    const uint8_t* text = (const uint8_t*)(in);
-    for (int i = 0; i < (int)insize; i++) {
-        out[i * 2]     = _hex[text[i] >> 4];
-        out[i * 2 + 1] = _hex[text[i] & 0xf];
-    }
-}
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "src/hex.cpp"
+#include <hwy/foreach_target.h>  // IWYU pragma: keep
 
-void hex__unmarshal(const char* in, size_t insize, char* out) {
-    if (insize & 1) {
-        throw std::runtime_error("Invalid hex text size");
-    }
-    for (int i = 0; i < (int)insize; i += 2) {
-        uint8_t hi, low;
-        HEX(hi, in[i]);
-        HEX(low, in[i + 1]);
-        if (hi > 16 || low > 16) {
-            fprintf(stderr, "hi:%d, lo:%d, %c\n", hi, low, in[i + 1]);
-            throw std::runtime_error("Invalid hex text");
-        }
-        out[i / 2] = hi << 4 | low;
-    }
-}
+#include "detail/hwy.h"
+#include <hwy/contrib/unroller/unroller-inl.h>
 
-}  // namespace unsimd
+HWY_BEFORE_NAMESPACE();
+namespace ss {
+namespace HWY_NAMESPACE {
 
 namespace {
 
-struct EncodeUnit : hn::UnrollerUnit<EncodeUnit, u8, u8> {
-    using D = hn::ScalableTag<u8>;
-    const vu8 _f             = hn::Set(_du8, 0xF);
-    const vu8 _hex_lut       = hn::LoadDup128(_du8, (const u8*)"0123456789abcdef");
+template <bool kSep>
+struct EncodeUnit : hn::UnrollerUnit<EncodeUnit<kSep>, u8, u8> {
+    using D                         = hn::ScalableTag<u8>;
+    static constexpr size_t kStride = kSep ? 3 : 2;
+    const vu8 _f                    = hn::Set(_du8, 0xF);
+    const vu8 _hex_lut;
+    const vu8 _sep;
 
     u8* _dest;
-    EncodeUnit(u8* dest) : _dest(dest) {}
+    EncodeUnit(u8* dest, bool upper, char sep)
+        : _hex_lut(hn::LoadDup128(
+              _du8, (const u8*)(upper ? "0123456789ABCDEF" : "0123456789abcdef"))),
+          _sep(hn::Set(_du8, (u8)sep)),
+          _dest(dest) {}
+
+    // With kSep every byte, the last one included, is followed by a separator.
+    void Encode(const vu8 x, u8* to) {
+        auto hi = hn::TableLookupBytes(_hex_lut, hn::ShiftRightSame(x, 4));
+        auto lo = hn::TableLookupBytes(_hex_lut, hn::And(x, _f));
+        if constexpr (kSep) {
+            hn::StoreInterleaved3(hi, lo, _sep, _du8, to);
+        } else {
+            hn::StoreInterleaved2(hi, lo, _du8, to);
+        }
+    }
 
     vu8 Func(const ptrdiff_t idx, const vu8 x, const vu8) {
-        auto higher_nibble = hn::ShiftRightSame(x, 4);
-        auto lower_nibble  = hn::And(x, _f);
-        auto hi            = hn::TableLookupBytes(_hex_lut, higher_nibble);
-        auto lo            = hn::TableLookupBytes(_hex_lut, lower_nibble);
-        hn::StoreInterleaved2(hi, lo, _du8, _dest + idx * 2);
+        Encode(x, _dest + idx * kStride);
         return hn::Zero(_du8);
     }
 
     bool StoreAndShortCircuitImpl(const ptrdiff_t idx, u8* to, const vu8 x) { return true; }
+
+    // Fewer than a vector of input left: load only what exists, encode into a
+    // stack block and keep its used prefix. No trailing separator.
+    void Tail(const u8* from, size_t n, u8* to) {
+        HWY_ALIGN u8 block[N8 * 3];
+        Encode(hn::LoadN(_du8, from, n), block);
+        memcpy(to, block, n * kStride - kSep);
+    }
 };
 
-struct DecodeUnit : hn::UnrollerUnit2D<DecodeUnit, u8, u8, u8> {
-    using D = hn::ScalableTag<u8>;
-    const vu8 _f             = hn::Set(_du8, 0xF);
-    // clang-format off
-    const vu8 _hex_lut = hn::Dup128VecFromValues(_du8,
-        /* 0 */ 0x10,        /* 1 */ 0x00,        /* 2 */ 0x00,        /* 3 */ 0x00 - 0x30,
-        /* 4 */ 0x0A - 0x41, /* 5 */ 0x00,        /* 6 */ 0x0A - 0x61, /* 7 */ 0x00,
-        /* 8 */ 0x00,        /* 9 */ 0x00,        /* a */ 0x00,        /* b */ 0x00,
-        /* c */ 0x00,        /* d */ 0x00,        /* e */ 0x00,        /* f */ 0x00);
-    // clang-format on
-    vu8 _x0 = hn::Zero(_du8);
-    vu8 _x1 = hn::Zero(_du8);
-
-    inline vu8 lookup_pshufb(const vu8& xx) {
-        const auto higher_nibble = hn::ShiftRightSame(xx, 4);
-        const auto result        = hn::Add(xx, hn::TableLookupBytes(_hex_lut, higher_nibble));
-        auto idx                 = hn::FindFirstTrue(_du8, hn::Gt(result, _f));
-        if (HWY_UNLIKELY(idx != -1)) {
-            throw ss::input_error(idx, 0);
-        }
-        return result;
+template <bool kSep>
+size_t EncodeBody(const u8* in, size_t len, bool upper, char sep, u8* out) {
+    EncodeUnit<kSep> unit(out, upper, sep);
+    // with a separator the last byte always goes through Tail
+    const size_t tail = kSep ? (len - 1) % N8 + 1 : len % N8;
+    if (len > tail) {
+        hn::Unroller(unit, const_cast<u8*>(in), out, len - tail);
+    }
+    if (tail > 0) {
+        const size_t start = len - tail;
+        unit.Tail(in + start, tail, out + start * unit.kStride);
+    }
+    return len * unit.kStride - kSep;
+}
+
+template <bool kWrite>
+struct DecodeUnit : hn::UnrollerUnit2D<DecodeUnit<kWrite>, u8, u8, u8> {
+    using D         = hn::ScalableTag<u8>;
+    const vu8 _0    = hn::Set(_du8, '0');
+    const vu8 _a    = hn::Set(_du8, 'a');
+    const vu8 _0x20 = hn::Set(_du8, 0x20);
+    const vu8 _6    = hn::Set(_du8, 6);
+    const vu8 _10   = hn::Set(_du8, 10);
+    vu8 _bad        = hn::Zero(_du8);  // non-hex lanes of every block, or-ed together
+    vu8 _x0         = hn::Zero(_du8);
+    vu8 _x1         = hn::Zero(_du8);
+
+    // '0'-'9' map to 0-9 and 'a'-'f' / 'A'-'F' to 10-15; anything else sets
+    // its lane in `bad`.
+    vu8 Nibbles(const vu8 x, vu8& bad) const {
+        const auto digit    = hn::Sub(x, _0);
+        const auto alpha    = hn::Sub(hn::Or(x, _0x20), _a);
+        const auto is_digit = hn::Lt(digit, _10);
+        const auto is_alpha = hn::Lt(alpha, _6);
+        bad = hn::Or(bad, hn::VecFromMask(_du8, hn::Not(hn::Or(is_digit, is_alpha))));
+        return hn::IfThenElse(is_digit, digit, hn::Add(alpha, _10));
     }
 
     vu8 Func(const ptrdiff_t idx, const vu8 x0, const vu8 x1, const vu8) {
-        vu8 xx0 = hn::Zero(_du8);
-        vu8 xx1 = hn::Zero(_du8);
-        try {
-            xx0 = lookup_pshufb(x0);
-        } catch (const ss::input_error& e) {
-            const auto shift = e.offset();
-            throw ss::input_error(idx * 2 + shift * 2, hn::ExtractLane(x0, shift));
-        }
-        try {
-            xx1 = lookup_pshufb(x1);
-        } catch (const ss::input_error& e) {
-            const auto shift = e.offset();
-            throw ss::input_error(idx * 2 + shift * 2 + 1, hn::ExtractLane(x1, shift));
+        const auto hi = Nibbles(x0, _bad);
+        const auto lo = Nibbles(x1, _bad);
+        if constexpr (!kWrite) {
+            return hn::Zero(_du8);
         }
-        return hn::Or(hn::ShiftLeftSame(xx0, 4), xx1);
+        return hn::Or(hn::ShiftLeftSame(hi, 4), lo);
     }
 
     vu8 Load0Impl(const ptrdiff_t idx, const u8* from) {
@@ -115,48 +111,190 @@ struct DecodeUnit : hn::UnrollerUnit2D<DecodeUnit, u8, u8, u8> {
     }
 
     vu8 Load1Impl(const ptrdiff_t idx, const u8* from) { return _x1; }
+
+    bool StoreAndShortCircuitImpl(const ptrdiff_t idx, u8* to, const vu8 x) {
+        if constexpr (kWrite) {
+            hn::StoreU(x, _du8, to + idx);
+        }
+        return true;
+    }
+
+    // Fewer than a vector of output left: pad the input with '0' in a stack
+    // block and decode it like a full one.
+    void Tail(const u8* from, size_t n, u8* to) {
+        HWY_ALIGN u8 block[N8 * 2];
+        memset(block, '0', sizeof(block));
+        memcpy(block, from, n * 2);
+        const auto x0 = Load0Impl(0, block);
+        const auto x  = Func(0, x0, Load1Impl(0, block), _bad);
+        if constexpr (kWrite) {
+            hn::StoreU(x, _du8, block);
+            memcpy(to, block, n);
+        }
+    }
+
+    // Only on the error path: where the first bad byte is.
+    size_t FirstBad(const u8* from, size_t len) const {
+        for (size_t i = 0; i < len; i += N8) {
+            const size_t n = HWY_MIN(N8, len - i);
+            vu8 bad        = hn::Zero(_du8);
+            Nibbles(hn::LoadNOr(_0, _du8, from + i, n), bad);
+            const intptr_t j = hn::FindFirstTrue(_du8, hn::MaskFromVec(bad));
+            if (j >= 0) {
+                return i + j;
+            }
+        }
+        return len;
+    }
 };
 
+template <bool kWrite>
+ss::decode_result DecodeBody(const u8* in, size_t len, u8* out) {
+    if (HWY_UNLIKELY(len & 1)) {
+        return {0, len, ss::decode_error::invalid_length};
+    }
+    const size_t olen = len / 2;
+    const size_t mod  = olen % N8;
+    DecodeUnit<kWrite> unit;
+    if (olen > mod) {
+        hn::Unroller(unit, const_cast<u8*>(in), const_cast<u8*>(in), out, olen - mod);
+    }
+    if (mod > 0) {
+        const size_t start = olen - mod;
+        unit.Tail(in + start * 2, mod, out + start);
+    }
+    if (HWY_UNLIKELY(!hn::AllFalse(_du8, hn::MaskFromVec(unit._bad)))) {
+        return {0, unit.FirstBad(in, len), ss::decode_error::invalid_byte};
+    }
+    return {olen, 0, ss::decode_error::none};
+}
+
 }  // namespace
 
+size_t HexEncode(const char* in, size_t len, const ss::hex_options& opts, char* out) {
+    size_t n = 0;
+    if (opts.prefix) {
+        out[n++] = '0';
+        out[n++] = 'x';
+    }
+    if (len == 0) {
+        return n;
+    }
+    if (opts.separator) {
+        return n + EncodeBody<true>((const u8*)in, len, opts.upper, opts.separator, (u8*)out + n);
+    }
+    return n + EncodeBody<false>((const u8*)in, len, opts.upper, 0, (u8*)out + n);
+}
+
+ss::decode_result HexDecode(const char* in, size_t len, char* out) {
+    return DecodeBody<true>((const u8*)in, len, (u8*)out);
+}
+
+ss::decode_result HexValidate(const char* in, size_t len) {
+    return DecodeBody<false>((const u8*)in, len, nullptr);
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+
 namespace ss {
 
-std::string hex_encode(const char* in, size_t len) {
-    static constexpr HWY_FULL(u8) _du8{};
-    static constexpr size_t N8 = hn::Lanes(_du8);
-    size_t mod                 = len % N8;
-    std::string result(2 * len, '\0');
-    if (len > mod) {
-        EncodeUnit unit((u8*)result.data());
-        hn::Unroller(unit, (u8*)(const_cast<char*>(in)), (u8*)result.data(), len - mod);
+HWY_EXPORT(HexEncode);
+HWY_EXPORT(HexDecode);
+HWY_EXPORT(HexValidate);
+
+namespace {
+
+// What the throwing decoders raise for a failed `r`.
+[[noreturn]] void throw_hex_error(const decode_result& r, const char* in) {
+    if (r.error == decode_error::invalid_length) {
+        throw std::runtime_error("Invalid hex text size");
     }
-    if (mod > 0) {
-        int start = len - mod;
-        unsimd::hex__marshal(in + start, mod, &result[start * 2]);
+    throw input_error(r.offset, in[r.offset]);
+}
+
+}  // namespace
+
+size_t hex_encode(const char* in, size_t len, const hex_options& opts, char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < hex_encode_size(in, len, opts))) {
+        throw std::length_error("Output buffer too small");
     }
-    return result;
+    return HWY_DYNAMIC_DISPATCH(HexEncode)(in, len, opts, out);
 }
 
-std::string hex_decode(const char* in, size_t len) {
-    static constexpr HWY_FULL(u8) _du8{};
-    static constexpr size_t N8 = hn::Lanes(_du8);
-    if (HWY_UNLIKELY(len & 1)) {
-        throw std::runtime_error("Invalid hex text size");
+size_t hex_encode(const char* in, size_t len, char* out, size_t cap) {
+    return hex_encode(in, len, hex_options{}, out, cap);
+}
+
+size_t hex_decode(const char* in, size_t len, char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < hex_decode_size(in, len))) {
+        throw std::length_error("Output buffer too small");
+    }
+    const auto r = HWY_DYNAMIC_DISPATCH(HexDecode)(in, len, out);
+    if (HWY_UNLIKELY(!r)) {
+        throw_hex_error(r, in);
     }
+    return r.size;
+}
 
-    size_t olen = len / 2;
-    auto mod = olen % N8;
-    std::string result(olen, '\0');
-    if (olen > mod) {
-        DecodeUnit unit;
-        hn::Unroller(unit, (u8*)(const_cast<char*>(in)), (u8*)(const_cast<char*>(in)),
-                     (u8*)result.data(), olen - mod);
+decode_result try_hex_decode(const char* in, size_t len, char* out, size_t cap) {
+    if (HWY_UNLIKELY(cap < hex_decode_size(in, len))) {
+        return {0, 0, decode_error::output_too_small};
     }
-    if (mod > 0) {
-        int start = olen - mod;
-        unsimd::hex__unmarshal(in + start * 2, mod * 2, &result[start]);
+    return HWY_DYNAMIC_DISPATCH(HexDecode)(in, len, out);
+}
+
+decode_result hex_validate(const char* in, size_t len) {
+    return HWY_DYNAMIC_DISPATCH(HexValidate)(in, len);
+}
+
+size_t hex_encode(const char* in, size_t len, const hex_options& opts, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + hex_encode_size(in, len, opts));
+    return HWY_DYNAMIC_DISPATCH(HexEncode)(in, len, opts, &out[pos]);
+}
+
+size_t hex_encode(const char* in, size_t len, std::string& out) {
+    return hex_encode(in, len, hex_options{}, out);
+}
+
+decode_result try_hex_decode(const char* in, size_t len, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + hex_decode_size(in, len));
+    const auto r = HWY_DYNAMIC_DISPATCH(HexDecode)(in, len, &out[pos]);
+    if (HWY_UNLIKELY(!r)) {
+        out.resize(pos);
+    }
+    return r;
+}
+
+size_t hex_decode(const char* in, size_t len, std::string& out) {
+    const auto r = try_hex_decode(in, len, out);
+    if (HWY_UNLIKELY(!r)) {
+        throw_hex_error(r, in);
     }
+    return r.size;
+}
+
+std::string hex_encode(const char* in, size_t len, const hex_options& opts) {
+    std::string result;
+    hex_encode(in, len, opts, result);
+    return result;
+}
+
+std::string hex_encode(const char* in, size_t len) {
+    return hex_encode(in, len, hex_options{});
+}
+
+std::string hex_decode(const char* in, size_t len) {
+    std::string result;
+    hex_decode(in, len, result);
     return result;
 }
 
 }  // namespace ss
+
+#endif  // HWY_ONCE
@@ -0,0 +1,104 @@
+#include "strings/hmac.h"
+#include <stdexcept>
+#include <string.h>
+
+namespace ss {
+
+namespace {
+
+constexpr size_t kBlockSize = 64;
+
+struct sha1_hash {
+    using ctx_t                   = SHA1_CTX;
+    static constexpr size_t kSize = sha1_digest_size;
+    static void init(ctx_t* c) { sha1_init(c); }
+    static void update(ctx_t* c, const char* p, size_t n) { sha1_update(c, p, n); }
+    static void final(ctx_t* c, char* out) { sha1_final(c, out, kSize); }
+};
+
+struct md5_hash {
+    using ctx_t                   = md5_ctx;
+    static constexpr size_t kSize = md5_digest_size;
+    static void init(ctx_t* c) { md5_init(c); }
+    static void update(ctx_t* c, const char* p, size_t n) { md5_update(c, p, n); }
+    static void final(ctx_t* c, char* out) { md5_final(c, out, kSize); }
+};
+
+// RFC 2104: keys longer than a block are hashed first, then zero padded.
+template <typename H>
+void hmac_absorb_key(const char* key, size_t len, typename H::ctx_t& inner,
+                     typename H::ctx_t& outer) {
+    char rkey[kBlockSize] = {0};
+    if (len > kBlockSize) {
+        typename H::ctx_t ctx;
+        H::init(&ctx);
+        H::update(&ctx, key, len);
+        H::final(&ctx, rkey);
+    } else {
+        memcpy(rkey, key, len);
+    }
+
+    char pad[kBlockSize];
+    for (size_t i = 0; i < kBlockSize; ++i) pad[i] = rkey[i] ^ 0x36;
+    H::init(&inner);
+    H::update(&inner, pad, kBlockSize);
+    for (size_t i = 0; i < kBlockSize; ++i) pad[i] = rkey[i] ^ 0x5c;
+    H::init(&outer);
+    H::update(&outer, pad, kBlockSize);
+}
+
+template <typename H>
+size_t hmac_sign(const typename H::ctx_t& inner, const typename H::ctx_t& outer,
+                 const char* msg, size_t len, char* out, size_t cap) {
+    if (cap < H::kSize) {
+        throw std::length_error("Output buffer too small");
+    }
+    char digest[H::kSize];
+    auto ctx = inner;
+    H::update(&ctx, msg, len);
+    H::final(&ctx, digest);
+    ctx = outer;
+    H::update(&ctx, digest, H::kSize);
+    H::final(&ctx, out);
+    return H::kSize;
+}
+
+}  // namespace
+
+hmac_sha1_key::hmac_sha1_key(const char* key, size_t len) {
+    hmac_absorb_key<sha1_hash>(key, len, inner_, outer_);
+}
+
+size_t hmac_sha1_key::sign(const char* msg, size_t len, char* out, size_t cap) const {
+    return hmac_sign<sha1_hash>(inner_, outer_, msg, len, out, cap);
+}
+
+hmac_md5_key::hmac_md5_key(const char* key, size_t len) {
+    hmac_absorb_key<md5_hash>(key, len, inner_, outer_);
+}
+
+size_t hmac_md5_key::sign(const char* msg, size_t len, char* out, size_t cap) const {
+    return hmac_sign<md5_hash>(inner_, outer_, msg, len, out, cap);
+}
+
+std::vector<char> hmac_sha1(const hmac_sha1_key& key, const char* msg, size_t len) {
+    std::vector<char> result(sha1_digest_size);
+    key.sign(msg, len, result.data(), result.size());
+    return result;
+}
+
+std::vector<char> hmac_sha1(const char* key, size_t key_len, const char* msg, size_t len) {
+    return hmac_sha1(hmac_sha1_key(key, key_len), msg, len);
+}
+
+std::vector<char> hmac_md5(const hmac_md5_key& key, const char* msg, size_t len) {
+    std::vector<char> result(md5_digest_size);
+    key.sign(msg, len, result.data(), result.size());
+    return result;
+}
+
+std::vector<char> hmac_md5(const char* key, size_t key_len, const char* msg, size_t len) {
+    return hmac_md5(hmac_md5_key(key, key_len), msg, len);
+}
+
+}  // namespace ss
@@ -5,17 +5,13 @@
 */
 
 #include "strings/md5.h"
+#include <stdexcept>
+#include <stdint.h>
 #include <string.h>
 
 #define HASHSIZE 16
 #define WORD     32
-#define MASK     0xFFFFFFFF
-#if __STDC_VERSION__ >= 199901L
-#    include <stdint.h>
 typedef uint32_t WORD32;
-#else
-typedef unsigned int WORD32;
-#endif
 
 /*
 ** Realiza a rotacao no sentido horario dos bits da variavel 'D' do tipo WORD32.
@@ -141,62 +137,105 @@ static inline void bytestoword32(WORD32* x, const char* pt) {
     }
 }
 
-static inline void put_length(WORD32* x, long len) {
-    /* in bits! */
-    x[14] = (WORD32)((len << 3) & MASK);
-    x[15] = (WORD32)(len >> (32 - 3) & 0x7);
+/* processa um bloco completo de 64 bytes */
+static inline void md5_transform(WORD32* d, const char* block) {
+    alignas(64) WORD32 wbuff[16];
+    WORD32 d_old[4];
+    bytestoword32(wbuff, block);
+    /*salva os valores do vetor digest*/
+    d_old[0] = d[0];
+    d_old[1] = d[1];
+    d_old[2] = d[2];
+    d_old[3] = d[3];
+    digest(wbuff, d);
+    d[0] += d_old[0];
+    d[1] += d_old[1];
+    d[2] += d_old[2];
+    d[3] += d_old[3];
 }
 
-/*
-** returned status:
-*  0 - normal message (full 64 bytes)
-*  1 - enough room for 0x80, but not for message length (two 4-byte words)
-*  2 - enough room for 0x80 plus message length (at least 9 bytes free)
-*/
-static int converte(WORD32* x, const char* pt, int num, int old_status) {
-    int new_status = 0;
-    char buff[64];
-    if (num < 64) {
-        memcpy(buff, pt, num); /* to avoid changing original string */
-        memset(buff + num, 0, 64 - num);
-        if (old_status == 0) buff[num] = '\200';
-        new_status = 1;
-        pt         = buff;
+static void md5_ctx_init(ss::md5_ctx* ctx) {
+    inic_digest(ctx->state);
+    ctx->count = 0;
+}
+
+static void md5_ctx_update(ss::md5_ctx* ctx, const char* data, size_t len) {
+    size_t j = ctx->count & 63;
+    size_t i = 0;
+    ctx->count += len;
+    if (j + len > 63) {
+        memcpy(ctx->buffer + j, data, (i = 64 - j));
+        md5_transform(ctx->state, (const char*)ctx->buffer);
+        /* full blocks are read in place */
+        for (; i + 63 < len; i += 64) {
+            md5_transform(ctx->state, data + i);
+        }
+        j = 0;
+    }
+    memcpy(ctx->buffer + j, data + i, len - i);
+}
+
+static void md5_ctx_final(ss::md5_ctx* ctx, char* output) {
+    static const char padding[64] = {'\200'};
+    const uint64_t bits           = ctx->count << 3;
+    const size_t j                = ctx->count & 63;
+    char length[8];
+    for (int k = 0; k < 8; ++k) {
+        length[k] = (char)(bits >> (8 * k));
     }
-    bytestoword32(x, pt);
-    if (num <= (64 - 9)) new_status = 2;
-    return new_status;
+    md5_ctx_update(ctx, padding, (j < 56) ? (56 - j) : (120 - j));
+    md5_ctx_update(ctx, length, 8);
+    word32tobytes(ctx->state, output);
+    memset(ctx, 0, sizeof(*ctx));
 }
 
 namespace ss {
 
-std::vector<char> md5(const char* message, size_t len) {
+std::unique_ptr<md5_ctx> md5_init() {
+    auto ctx = std::make_unique<md5_ctx>();
+    md5_ctx_init(ctx.get());
+    return ctx;
+}
+
+void md5_init(md5_ctx* ctx) {
+    md5_ctx_init(ctx);
+}
+
+void md5_update(md5_ctx* ctx, const char* buf, size_t len) {
+    md5_ctx_update(ctx, buf, len);
+}
+
+std::vector<char> md5_final(md5_ctx* ctx) {
     std::vector<char> result(HASHSIZE);
-    char* output = &result[0];
-    WORD32 d[4];
-    int status = 0;
-    long i     = 0;
-    inic_digest(d);
-    while (status != 2) {
-        WORD32 d_old[4];
-        WORD32 wbuff[16];
-        int numbytes = (len - i >= 64) ? 64 : len - i;
-        /*salva os valores do vetor digest*/
-        d_old[0] = d[0];
-        d_old[1] = d[1];
-        d_old[2] = d[2];
-        d_old[3] = d[3];
-        status   = converte(wbuff, message + i, numbytes, status);
-        if (status == 2) put_length(wbuff, len);
-        digest(wbuff, d);
-        d[0] += d_old[0];
-        d[1] += d_old[1];
-        d[2] += d_old[2];
-        d[3] += d_old[3];
-        i += numbytes;
+    md5_ctx_final(ctx, &result[0]);
+    return result;
+}
+
+size_t md5_final(md5_ctx* ctx, char* out, size_t cap) {
+    if (cap < HASHSIZE) {
+        throw std::length_error("Output buffer too small");
     }
-    word32tobytes(d, output);
+    md5_ctx_final(ctx, out);
+    return HASHSIZE;
+}
+
+std::vector<char> md5(const char* message, size_t len) {
+    std::vector<char> result(HASHSIZE);
+    md5(message, len, &result[0], HASHSIZE);
     return result;
 }
 
+size_t md5(const char* message, size_t len, char* out, size_t cap) {
+    md5_ctx ctx;
+    md5_ctx_init(&ctx);
+    md5_ctx_update(&ctx, message, len);
+    return md5_final(&ctx, out, cap);
+}
+
+size_t md5(const char* message, size_t len, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + HASHSIZE);
+    return md5(message, len, &out[pos], HASHSIZE);
+}
+
 }  // namespace ss
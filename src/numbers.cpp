@@ -0,0 +1,475 @@
+#include "strings/numbers.h"
+#include <charconv>
+#include <locale.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <strings/core.h>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "src/numbers.cpp"
+#include <hwy/foreach_target.h>  // IWYU pragma: keep
+
+#include "detail/hwy.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace ss {
+namespace HWY_NAMESPACE {
+
+// Up to 16 digits in one 128-bit vector: validate, right-align with
+// TableLookupBytesOr0, then fold digit pairs (x10) and pairs of pairs (x100)
+// with widening multiply-adds into four 4-digit groups. Longer fields take
+// the scalar path.
+HWY_INLINE std::errc ParseField(const char* p, size_t n, int64_t& value, size_t& err) {
+    static constexpr hn::FixedTag<u8, 16> d8;
+    static constexpr hn::FixedTag<i8, 16> di8;
+    static constexpr hn::FixedTag<i16, 8> d16;
+    static constexpr hn::FixedTag<i32, 4> d32;
+    // Row `nd` (a load at kAlign + nd) moves lanes [0, nd) to the top, zeroing the rest.
+    alignas(16) static constexpr u8 kAlign[32] = {
+        0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+        0x80, 0,    1,    2,    3,    4,    5,    6,    7,    8,    9,    10,   11,   12,   13,
+        14,   15};
+
+    const size_t sign = n != 0 && (p[0] == '-' || p[0] == '+');
+    const size_t nd   = n - sign;
+    if (nd == 0 || nd > 16) {
+        return detail::parse_int(std::string_view(p, n), value, err);
+    }
+
+    const auto digits = hn::Sub(hn::LoadN(d8, (const u8*)p + sign, nd), hn::Set(d8, '0'));
+    const auto bad    = hn::And(hn::Gt(digits, hn::Set(d8, 9)), hn::FirstN(d8, nd));
+    const intptr_t k  = hn::FindFirstTrue(d8, bad);
+    if (HWY_UNLIKELY(k >= 0)) {
+        err = sign + k;
+        return std::errc::invalid_argument;
+    }
+
+    const auto aligned = hn::TableLookupBytesOr0(digits, hn::LoadU(d8, kAlign + nd));
+    const auto pairs   = hn::SatWidenMulPairwiseAdd(
+        d16, aligned, hn::BitCast(di8, hn::Set(hn::FixedTag<u16, 8>(), 0x010A)));
+    const auto quads =
+        hn::WidenMulPairwiseAdd(d32, pairs, hn::BitCast(d16, hn::Set(d32, 0x00010064)));
+    alignas(16) int32_t g[4];
+    hn::Store(quads, d32, g);
+    const uint64_t mag = ((uint64_t)g[0] * 10000 + (uint64_t)g[1]) * 100000000 +
+                         (uint64_t)g[2] * 10000 + (uint64_t)g[3];
+    value = p[0] == '-' ? -(int64_t)mag : (int64_t)mag;
+    return std::errc();
+}
+
+void ParseIntColumn(const char* s, size_t len, char delim, std::vector<int64_t>& out,
+                    std::vector<column_error>& errors) {
+    const auto* src   = (const u8*)s;
+    const auto vdelim = hn::Set(_du8, (u8)delim);
+    size_t start      = 0;
+
+    auto field = [&](size_t end) {
+        int64_t v     = 0;
+        size_t err    = 0;
+        const auto ec = ParseField(s + start, end - start, v, err);
+        if (HWY_UNLIKELY(ec != std::errc())) {
+            errors.push_back({out.size(), start + err, ec});
+            v = 0;
+        }
+        out.push_back(v);
+        start = end + 1;
+    };
+    auto emit = [&](size_t idx, hn::Mask<decltype(_du8)> delims) {
+        uint8_t bytes[8] = {0};
+        hn::StoreMaskBits(_du8, delims, bytes);
+        uint64_t bits;
+        memcpy(&bits, bytes, sizeof(bits));
+        for (; bits != 0; bits &= bits - 1) {
+            field(idx + hwy::Num0BitsBelowLS1Bit_Nonzero64(bits));
+        }
+    };
+
+    size_t idx = 0;
+    for (; idx + N8 <= len; idx += N8) {
+        const auto m = hn::Eq(hn::LoadU(_du8, src + idx), vdelim);
+        if (!hn::AllFalse(_du8, m)) {
+            emit(idx, m);
+        }
+    }
+    if (idx != len) {
+        const size_t n = len - idx;
+        emit(idx, hn::And(hn::Eq(hn::LoadN(_du8, src + idx, n), vdelim), hn::FirstN(_du8, n)));
+    }
+    field(len);
+}
+
+void ParseIntFields(const std::string_view* fields, size_t count, std::vector<int64_t>& out,
+                    std::vector<column_error>& errors) {
+    for (size_t i = 0; i < count; ++i) {
+        int64_t v     = 0;
+        size_t err    = 0;
+        const auto ec = ParseField(fields[i].data(), fields[i].size(), v, err);
+        if (HWY_UNLIKELY(ec != std::errc())) {
+            errors.push_back({i, err, ec});
+            v = 0;
+        }
+        out.push_back(v);
+    }
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+
+#include "detail/pow5.h"
+
+namespace ss {
+
+namespace detail {
+
+std::errc parse_magnitude(std::string_view s, uint64_t& mag, bool& neg, size_t& err) {
+    size_t i = 0;
+    neg      = false;
+    if (!s.empty() && (s[0] == '-' || s[0] == '+')) {
+        neg = s[0] == '-';
+        i   = 1;
+    }
+    if (i == s.size()) {
+        err = i;
+        return std::errc::invalid_argument;
+    }
+    uint64_t v    = 0;
+    bool overflow = false;
+    for (; i < s.size(); ++i) {
+        const unsigned d = (unsigned char)s[i] - '0';
+        if (d > 9) {
+            err = i;
+            return std::errc::invalid_argument;
+        }
+        overflow |= v > (UINT64_MAX - d) / 10;
+        v = v * 10 + d;
+    }
+    if (overflow) {
+        err = 0;
+        return std::errc::result_out_of_range;
+    }
+    mag = v;
+    return std::errc();
+}
+
+namespace {
+
+constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                             1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                             1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+constexpr uint64_t kInfBits = 0x7FF0000000000000ull;
+
+// Eisel-Lemire: w * 10^q rounded to the nearest double, as IEEE bits without
+// the sign. False when the 128-bit product cannot decide the rounding.
+bool eisel_lemire(int64_t q, uint64_t w, uint64_t& bits) {
+    if (q < kPow5Min) {
+        bits = 0;
+        return true;
+    }
+    if (q > kPow5Max) {
+        bits = kInfBits;
+        return true;
+    }
+    const int lz = (int)hwy::Num0BitsAboveMS1Bit_Nonzero64(w);
+    w <<= lz;
+    const size_t index = 2 * (size_t)(q - kPow5Min);
+    uint64_t hi;
+    uint64_t lo = hwy::Mul128(w, kPow5[index], &hi);
+    if ((hi & 0x1FF) == 0x1FF) {  // the 55 bits kept may be off by one, refine
+        uint64_t hi2;
+        hwy::Mul128(w, kPow5[index + 1], &hi2);
+        lo += hi2;
+        hi += hi2 > lo;
+        if (lo == UINT64_MAX && (q < -27 || q > 55)) {
+            return false;
+        }
+    }
+    const int upper   = (int)(hi >> 63);
+    uint64_t mantissa = hi >> (upper + 9);
+    // floor(log2(10^q)) + 63, + upper, - lz, rebased on the exponent bias
+    int power2 = (int)(((152170 + 65536) * q) >> 16) + 63 + upper - lz + 1023;
+    if (power2 <= 0) {  // subnormal
+        if (-power2 + 1 >= 64) {
+            bits = 0;
+            return true;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        bits = mantissa;  // a carry into bit 52 makes it the smallest normal
+        return true;
+    }
+    // exactly halfway between two doubles: round to even
+    if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+        (mantissa << (upper + 9)) == hi) {
+        mantissa &= ~1ull;
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (2ull << 52)) {
+        mantissa = 1ull << 52;
+        ++power2;
+    }
+    if (power2 >= 0x7FF) {
+        bits = kInfBits;
+        return true;
+    }
+    bits = (mantissa & ~(1ull << 52)) | (uint64_t)power2 << 52;
+    return true;
+}
+
+double from_bits(uint64_t bits) {
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+double slow_parse(std::string_view s) {
+    double d = 0;
+#if defined(__cpp_lib_to_chars)
+    std::from_chars(s.data(), s.data() + s.size(), d);
+#else
+    // Assumes the "C" locale decimal point.
+    const std::string tmp(s);
+    d = strtod(tmp.c_str(), nullptr);
+#endif
+    return d;
+}
+
+}  // namespace
+
+std::errc parse_float(std::string_view s, double& value, size_t& err) {
+    const size_t n = s.size();
+    size_t i       = 0;
+    bool neg       = false;
+    if (i < n && (s[i] == '-' || s[i] == '+')) {
+        neg = s[i] == '-';
+        ++i;
+    }
+    auto is_digit = [&](size_t j) { return j < n && (unsigned)((unsigned char)s[j] - '0') <= 9; };
+    if (!is_digit(i) && !(i < n && s[i] == '.')) {
+        const auto word = s.substr(i);
+        if (str_iequals(word, "inf") || str_iequals(word, "infinity")) {
+            value = neg ? -HUGE_VAL : HUGE_VAL;
+            return std::errc();
+        }
+        if (str_iequals(word, "nan")) {
+            value = neg ? -NAN : NAN;
+            return std::errc();
+        }
+        err = i;
+        return std::errc::invalid_argument;
+    }
+
+    // Up to 19 significant digits go to w; the rest only move the exponent.
+    uint64_t w     = 0;
+    int64_t exp10  = 0;
+    int ndigits    = 0;
+    bool truncated = false;
+    bool any       = false;
+    auto digit     = [&](unsigned d, bool fraction) {
+        any = true;
+        if (w == 0 && d == 0) {
+            exp10 -= fraction;
+        } else if (ndigits < 19) {
+            w = w * 10 + d;
+            ++ndigits;
+            exp10 -= fraction;
+        } else {
+            exp10 += !fraction;
+            truncated |= d != 0;
+        }
+    };
+    for (; is_digit(i); ++i) {
+        digit(s[i] - '0', false);
+    }
+    if (i < n && s[i] == '.') {
+        for (++i; is_digit(i); ++i) {
+            digit(s[i] - '0', true);
+        }
+    }
+    if (!any) {
+        err = i;
+        return std::errc::invalid_argument;
+    }
+    if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+        ++i;
+        bool eneg = false;
+        if (i < n && (s[i] == '-' || s[i] == '+')) {
+            eneg = s[i] == '-';
+            ++i;
+        }
+        if (!is_digit(i)) {
+            err = i;
+            return std::errc::invalid_argument;
+        }
+        int64_t e = 0;
+        for (; is_digit(i); ++i) {
+            e = HWY_MIN(e * 10 + (s[i] - '0'), (int64_t)1 << 32);
+        }
+        exp10 += eneg ? -e : e;
+    }
+    if (i != n) {
+        err = i;
+        return std::errc::invalid_argument;
+    }
+
+    double d;
+    uint64_t bits, bits1;
+    if (w == 0) {
+        d = 0;
+    } else if (!truncated && w <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+        // Clinger: both operands are exact, so one rounding
+        d = exp10 < 0 ? (double)w / kPow10[-exp10] : (double)w * kPow10[exp10];
+    } else if (eisel_lemire(exp10, w, bits) &&
+               (!truncated || (eisel_lemire(exp10, w + 1, bits1) && bits == bits1))) {
+        d = from_bits(bits);
+    } else {
+        d = slow_parse(s.substr(neg || s[0] == '+'));
+    }
+    if (HWY_UNLIKELY(d == HUGE_VAL)) {
+        err = 0;
+        return std::errc::result_out_of_range;
+    }
+    value = neg ? -d : d;
+    return std::errc();
+}
+
+}  // namespace detail
+
+bool try_parse_float(std::string_view s, double& value) {
+    size_t err;
+    return detail::parse_float(s, value, err) == std::errc();
+}
+
+double parse_float(std::string_view s) {
+    double value  = 0;
+    size_t err    = 0;
+    const auto ec = detail::parse_float(s, value, err);
+    if (ec == std::errc::invalid_argument) {
+        throw input_error(err, err < s.size() ? s[err] : 0);
+    }
+    if (ec == std::errc::result_out_of_range) {
+        throw std::out_of_range("Float out of range");
+    }
+    return value;
+}
+
+size_t format_int(uint64_t v, char* out, size_t cap) {
+    static constexpr char kDigits2[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+    char buf[format_int_max_size];
+    char* p = buf + sizeof(buf);
+    for (; v >= 100; v /= 100) {
+        p -= 2;
+        memcpy(p, kDigits2 + v % 100 * 2, 2);
+    }
+    if (v >= 10) {
+        p -= 2;
+        memcpy(p, kDigits2 + v * 2, 2);
+    } else {
+        *--p = (char)('0' + v);
+    }
+    const size_t n = buf + sizeof(buf) - p;
+    if (HWY_UNLIKELY(cap < n)) {
+        throw std::length_error("Output buffer too small");
+    }
+    memcpy(out, p, n);
+    return n;
+}
+
+size_t format_int(int64_t v, char* out, size_t cap) {
+    if (v >= 0) {
+        return format_int((uint64_t)v, out, cap);
+    }
+    if (HWY_UNLIKELY(cap == 0)) {
+        throw std::length_error("Output buffer too small");
+    }
+    out[0] = '-';
+    return 1 + format_int(0 - (uint64_t)v, out + 1, cap - 1);
+}
+
+size_t format_float(double v, char* out, size_t cap) {
+#if defined(__cpp_lib_to_chars)
+    const auto r = std::to_chars(out, out + cap, v);
+    if (HWY_UNLIKELY(r.ec != std::errc())) {
+        throw std::length_error("Output buffer too small");
+    }
+    return r.ptr - out;
+#else
+    // The fewest significant digits that parse back to `v`, then whichever
+    // of %g, scientific and fixed notation is the shortest with them, e.g.
+    // "100" rather than "1e+02" and "1e-04" rather than "0.0001".
+    char tmp[32], other[32];
+    int n = 0, digits = 1;
+    for (; digits <= 17; ++digits) {
+        n = snprintf(tmp, sizeof(tmp), "%.*g", digits, v);
+        if (!isfinite(v) || strtod(tmp, nullptr) == v) {
+            break;
+        }
+    }
+    auto keep_shorter = [&](int m) {
+        if (m < n && strtod(other, nullptr) == v) {
+            memcpy(tmp, other, m);
+            n = m;
+        }
+    };
+    keep_shorter(snprintf(other, sizeof(other), "%.*e", digits - 1, v));
+    const char* e = (const char*)memchr(tmp, 'e', n);
+    if (e != nullptr && e[1] == '+') {
+        // past 17 digits %.0f prints the exact integer, as to_chars does
+        const int exp = atoi(e + 2);
+        keep_shorter(exp < 17 ? snprintf(other, sizeof(other), "%.*g", exp + 1, v)
+                              : snprintf(other, sizeof(other), "%.0f", v));
+    }
+    // snprintf writes the locale's decimal point, to_chars always '.'.
+    const std::string_view point = localeconv()->decimal_point;
+    const size_t at              = std::string_view(tmp, n).find(point);
+    if (point != "." && !point.empty() && at != std::string_view::npos) {
+        tmp[at] = '.';
+        memmove(tmp + at + 1, tmp + at + point.size(), n - at - point.size());
+        n -= (int)point.size() - 1;
+    }
+    if (HWY_UNLIKELY((size_t)n > cap)) {
+        throw std::length_error("Output buffer too small");
+    }
+    memcpy(out, tmp, n);
+    return n;
+#endif
+}
+
+HWY_EXPORT(ParseIntColumn);
+HWY_EXPORT(ParseIntFields);
+
+size_t parse_int_column(std::string_view column, char delimiter, std::vector<int64_t>& out,
+                        std::vector<column_error>& errors) {
+    out.clear();
+    errors.clear();
+    if (!column.empty()) {
+        HWY_DYNAMIC_DISPATCH(ParseIntColumn)
+        (column.data(), column.size(), delimiter, out, errors);
+    }
+    return out.size();
+}
+
+size_t parse_int_column(const std::vector<std::string_view>& fields, std::vector<int64_t>& out,
+                        std::vector<column_error>& errors) {
+    out.clear();
+    errors.clear();
+    out.reserve(fields.size());
+    HWY_DYNAMIC_DISPATCH(ParseIntFields)(fields.data(), fields.size(), out, errors);
+    return out.size();
+}
+
+}  // namespace ss
+
+#endif  // HWY_ONCE
@@ -1 +1,34 @@
 #include "strings/object.h"
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "src/object.cpp"
+#include <hwy/foreach_target.h>  // IWYU pragma: keep
+
+#include <hwy/highway.h>
+#include <hwy/targets.h>
+
+HWY_BEFORE_NAMESPACE();
+namespace ss {
+namespace HWY_NAMESPACE {
+
+const char* ActiveTarget() {
+    return hwy::TargetName(HWY_TARGET);
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace ss
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+
+namespace ss {
+
+HWY_EXPORT(ActiveTarget);
+
+const char* active_target() {
+    return HWY_DYNAMIC_DISPATCH(ActiveTarget)();
+}
+
+}  // namespace ss
+
+#endif  // HWY_ONCE
@@ -88,11 +88,9 @@ A million repetitions of "a"
 #include <string.h>
 #include <stdint.h>
 
-struct SHA1_CTX {
-	uint32_t state[5];
-	uint32_t count[2];
-	uint8_t  buffer[64];
-} ;
+#include <strings/sha1.h>
+#include <atomic>
+#include <stdexcept>
 
 #define SHA1_DIGEST_SIZE 20
 
@@ -173,6 +171,228 @@ static void	SHA1_Transform(uint32_t	state[5], const	uint8_t	buffer[64])
 }
 
 
+// Hardware backends. Each processes `blocks` consecutive 64-byte blocks and
+// keeps the state in registers between them; the scalar one is the fallback.
+
+typedef void (*sha1_blocks_fn)(uint32_t state[5], const uint8_t* data, size_t blocks);
+
+static void sha1_blocks_scalar(uint32_t state[5], const uint8_t* data, size_t blocks) {
+    for (; blocks > 0; --blocks, data += 64) {
+        SHA1_Transform(state, data);
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define STRINGS_SHA1_X86 1
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        include <intrin.h>
+#        define SHA1_NI_TARGET
+#    else
+#        include <cpuid.h>
+#        define SHA1_NI_TARGET __attribute__((target("sha,sse4.1")))
+#    endif
+
+static bool sha1_ni_supported() {
+    unsigned int abcd[4] = {0};
+#    if defined(_MSC_VER) && !defined(__clang__)
+    __cpuidex((int*)abcd, 1, 0);
+    const bool sse41 = (abcd[2] >> 19) & 1;
+    __cpuidex((int*)abcd, 7, 0);
+#    else
+    if (!__get_cpuid(1, &abcd[0], &abcd[1], &abcd[2], &abcd[3])) {
+        return false;
+    }
+    const bool sse41 = (abcd[2] >> 19) & 1;
+    if (!__get_cpuid_count(7, 0, &abcd[0], &abcd[1], &abcd[2], &abcd[3])) {
+        return false;
+    }
+#    endif
+    return sse41 && ((abcd[1] >> 29) & 1);
+}
+
+// Group k (4 rounds) of 20. Rounds alternate E0/E1; the message schedule runs
+// msg1 three groups ahead, the xor two ahead and msg2 one ahead.
+#    define SHA1_NI_GROUP(k, X, Y, M0, M1, M2, M3)              \
+        X    = _mm_sha1nexte_epu32(X, M0);                      \
+        Y    = abcd;                                            \
+        if (k >= 3 && k <= 18) M1 = _mm_sha1msg2_epu32(M1, M0); \
+        abcd = _mm_sha1rnds4_epu32(abcd, X, k / 5);             \
+        if (k >= 1 && k <= 16) M3 = _mm_sha1msg1_epu32(M3, M0); \
+        if (k >= 2 && k <= 17) M2 = _mm_xor_si128(M2, M0);
+
+SHA1_NI_TARGET
+static void sha1_blocks_ni(uint32_t state[5], const uint8_t* data, size_t blocks) {
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    __m128i abcd       = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1B);
+    __m128i e0         = _mm_set_epi32((int)state[4], 0, 0, 0);
+    __m128i e1, m0, m1, m2, m3;
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const __m128i abcd_save = abcd;
+        const __m128i e0_save   = e0;
+
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), mask);
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), mask);
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), mask);
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), mask);
+
+        // group 0 adds the message instead of sha1nexte
+        e0   = _mm_add_epi32(e0, m0);
+        e1   = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        SHA1_NI_GROUP(1, e1, e0, m1, m2, m3, m0);
+        SHA1_NI_GROUP(2, e0, e1, m2, m3, m0, m1);
+        SHA1_NI_GROUP(3, e1, e0, m3, m0, m1, m2);
+        SHA1_NI_GROUP(4, e0, e1, m0, m1, m2, m3);
+        SHA1_NI_GROUP(5, e1, e0, m1, m2, m3, m0);
+        SHA1_NI_GROUP(6, e0, e1, m2, m3, m0, m1);
+        SHA1_NI_GROUP(7, e1, e0, m3, m0, m1, m2);
+        SHA1_NI_GROUP(8, e0, e1, m0, m1, m2, m3);
+        SHA1_NI_GROUP(9, e1, e0, m1, m2, m3, m0);
+        SHA1_NI_GROUP(10, e0, e1, m2, m3, m0, m1);
+        SHA1_NI_GROUP(11, e1, e0, m3, m0, m1, m2);
+        SHA1_NI_GROUP(12, e0, e1, m0, m1, m2, m3);
+        SHA1_NI_GROUP(13, e1, e0, m1, m2, m3, m0);
+        SHA1_NI_GROUP(14, e0, e1, m2, m3, m0, m1);
+        SHA1_NI_GROUP(15, e1, e0, m3, m0, m1, m2);
+        SHA1_NI_GROUP(16, e0, e1, m0, m1, m2, m3);
+        SHA1_NI_GROUP(17, e1, e0, m1, m2, m3, m0);
+        SHA1_NI_GROUP(18, e0, e1, m2, m3, m0, m1);
+        SHA1_NI_GROUP(19, e1, e0, m3, m0, m1, m2);
+
+        e0   = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+#    undef SHA1_NI_GROUP
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define STRINGS_SHA1_ARM 1
+#    include <arm_neon.h>
+#    if defined(__clang__)
+#        define SHA1_ARM_TARGET __attribute__((target("sha2")))
+#    elif defined(__GNUC__)
+#        define SHA1_ARM_TARGET __attribute__((target("+crypto")))
+#    else
+#        define SHA1_ARM_TARGET
+#    endif
+#    if defined(__linux__)
+#        include <sys/auxv.h>
+#        include <asm/hwcap.h>
+#    elif defined(_WIN32)
+#        include <windows.h>
+#    endif
+
+static bool sha1_arm_supported() {
+#    if defined(__APPLE__)
+    return true;
+#    elif defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_SHA1) != 0;
+#    elif defined(_WIN32)
+    return IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE);
+#    else
+    return false;
+#    endif
+}
+
+// Group k (4 rounds) of 20. Rounds alternate E0/E1; the schedule runs su0 four
+// groups ahead, su1 three ahead and the constant add two ahead.
+#    define SHA1_ARM_GROUP(k, op, X, Y, T, M0, M1, M2, M3)                       \
+        Y    = vsha1h_u32(vgetq_lane_u32(abcd, 0));                              \
+        abcd = op(abcd, X, T);                                                   \
+        if (k <= 17) T = vaddq_u32(M2, vdupq_n_u32(_sha1_k[(k + 2) / 5]));      \
+        if (k >= 1 && k <= 16) M3 = vsha1su1q_u32(M3, M2);                       \
+        if (k <= 15) M0 = vsha1su0q_u32(M0, M1, M2);
+
+static const uint32_t _sha1_k[4] = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6};
+
+SHA1_ARM_TARGET
+static void sha1_blocks_arm(uint32_t state[5], const uint8_t* data, size_t blocks) {
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e0     = state[4];
+    uint32_t e1;
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const uint32x4_t abcd_save = abcd;
+        const uint32_t e0_save     = e0;
+
+        uint32x4_t m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 0)));
+        uint32x4_t m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+        uint32x4_t m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+        uint32x4_t m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+        uint32x4_t t0 = vaddq_u32(m0, vdupq_n_u32(_sha1_k[0]));
+        uint32x4_t t1 = vaddq_u32(m1, vdupq_n_u32(_sha1_k[0]));
+
+        SHA1_ARM_GROUP(0, vsha1cq_u32, e0, e1, t0, m0, m1, m2, m3);
+        SHA1_ARM_GROUP(1, vsha1cq_u32, e1, e0, t1, m1, m2, m3, m0);
+        SHA1_ARM_GROUP(2, vsha1cq_u32, e0, e1, t0, m2, m3, m0, m1);
+        SHA1_ARM_GROUP(3, vsha1cq_u32, e1, e0, t1, m3, m0, m1, m2);
+        SHA1_ARM_GROUP(4, vsha1cq_u32, e0, e1, t0, m0, m1, m2, m3);
+        SHA1_ARM_GROUP(5, vsha1pq_u32, e1, e0, t1, m1, m2, m3, m0);
+        SHA1_ARM_GROUP(6, vsha1pq_u32, e0, e1, t0, m2, m3, m0, m1);
+        SHA1_ARM_GROUP(7, vsha1pq_u32, e1, e0, t1, m3, m0, m1, m2);
+        SHA1_ARM_GROUP(8, vsha1pq_u32, e0, e1, t0, m0, m1, m2, m3);
+        SHA1_ARM_GROUP(9, vsha1pq_u32, e1, e0, t1, m1, m2, m3, m0);
+        SHA1_ARM_GROUP(10, vsha1mq_u32, e0, e1, t0, m2, m3, m0, m1);
+        SHA1_ARM_GROUP(11, vsha1mq_u32, e1, e0, t1, m3, m0, m1, m2);
+        SHA1_ARM_GROUP(12, vsha1mq_u32, e0, e1, t0, m0, m1, m2, m3);
+        SHA1_ARM_GROUP(13, vsha1mq_u32, e1, e0, t1, m1, m2, m3, m0);
+        SHA1_ARM_GROUP(14, vsha1mq_u32, e0, e1, t0, m2, m3, m0, m1);
+        SHA1_ARM_GROUP(15, vsha1pq_u32, e1, e0, t1, m3, m0, m1, m2);
+        SHA1_ARM_GROUP(16, vsha1pq_u32, e0, e1, t0, m0, m1, m2, m3);
+        SHA1_ARM_GROUP(17, vsha1pq_u32, e1, e0, t1, m1, m2, m3, m0);
+        SHA1_ARM_GROUP(18, vsha1pq_u32, e0, e1, t0, m2, m3, m0, m1);
+        SHA1_ARM_GROUP(19, vsha1pq_u32, e1, e0, t1, m3, m0, m1, m2);
+
+        e0 += e0_save;
+        abcd = vaddq_u32(abcd, abcd_save);
+    }
+
+    vst1q_u32(state, abcd);
+    state[4] = e0;
+}
+
+#    undef SHA1_ARM_GROUP
+
+#endif
+
+struct sha1_backend_t {
+    const char* name;
+    sha1_blocks_fn fn;
+    bool (*supported)();
+};
+
+// fastest first
+static const sha1_backend_t _sha1_backends[] = {
+#if defined(STRINGS_SHA1_X86)
+    {"sha-ni", sha1_blocks_ni, sha1_ni_supported},
+#elif defined(STRINGS_SHA1_ARM)
+    {"armv8", sha1_blocks_arm, sha1_arm_supported},
+#endif
+    {"scalar", sha1_blocks_scalar, [] { return true; }},
+};
+
+static std::atomic<const sha1_backend_t*>& sha1_selected() {
+    static std::atomic<const sha1_backend_t*> selected{[] {
+        for (const auto& b : _sha1_backends) {
+            if (b.supported()) return &b;
+        }
+        return &_sha1_backends[0];
+    }()};
+    return selected;
+}
+
+static inline void sha1_blocks(uint32_t state[5], const uint8_t* data, size_t blocks) {
+    sha1_selected().load(std::memory_order_relaxed)->fn(state, data, blocks);
+}
+
+
 /* SHA1Init	- Initialize new context */
 static void sat_SHA1_Init(SHA1_CTX* context)
 {
@@ -200,10 +420,9 @@ static void sat_SHA1_Update(SHA1_CTX* context,	const uint8_t* data, const size_t
 	context->count[1] += (len >> 29);
 	if ((j + len) >	63)	{
 		memcpy(&context->buffer[j],	data, (i = 64-j));
-		SHA1_Transform(context->state, context->buffer);
-		for	( ;	i +	63 < len; i	+= 64) {
-			SHA1_Transform(context->state, data	+ i);
-		}
+		sha1_blocks(context->state, context->buffer, 1);
+		sha1_blocks(context->state, data + i, (len - i) / 64);
+		i += (len - i) & ~(size_t)63;
 		j =	0;
 	}
 	else i = 0;
@@ -225,10 +444,9 @@ static void sat_SHA1_Final(SHA1_CTX* context, uint8_t digest[SHA1_DIGEST_SIZE])
 		finalcount[i] =	(unsigned char)((context->count[(i >= 4	? 0	: 1)]
 		 >>	((3-(i & 3)) * 8) )	& 255);	 /*	Endian independent */
 	}
-	sat_SHA1_Update(context, (uint8_t *)"\200",	1);
-	while ((context->count[0] &	504) !=	448) {
-		sat_SHA1_Update(context, (uint8_t *)"\0", 1);
-	}
+	static const uint8_t padding[64] = {0x80};
+	i =	(context->count[0] >> 3) & 63;
+	sat_SHA1_Update(context, padding, (i < 56) ? (56 - i) : (120 - i));
 	sat_SHA1_Update(context, finalcount, 8);  /* Should	cause a	SHA1_Transform() */
 	for	(i = 0;	i <	SHA1_DIGEST_SIZE; i++) {
 		digest[i] =	(uint8_t)
@@ -243,8 +461,6 @@ static void sat_SHA1_Final(SHA1_CTX* context, uint8_t digest[SHA1_DIGEST_SIZE])
 	memset(finalcount, 0, 8);	/* SWR */
 }
 
-#include <strings/sha1.h>
-
 namespace ss {
 
 std::unique_ptr<SHA1_CTX> sha1_init() {
@@ -253,96 +469,60 @@ std::unique_ptr<SHA1_CTX> sha1_init() {
     return ctx;
 }
 
+void sha1_init(SHA1_CTX *ctx) {
+    sat_SHA1_Init(ctx);
+}
+
 void sha1_update(SHA1_CTX *ctx, const char* buf, size_t len) {
     sat_SHA1_Update(ctx, (const uint8_t*)buf, len);
 }
 
+const char* sha1_backend() {
+    return sha1_selected().load()->name;
+}
+
+bool sha1_set_backend(const char* name) {
+    for (const auto& b : _sha1_backends) {
+        if (strcmp(b.name, name) == 0 && b.supported()) {
+            sha1_selected().store(&b);
+            return true;
+        }
+    }
+    return false;
+}
+
 std::vector<char> sha1_final(SHA1_CTX *ctx) {
     std::vector<char> result(SHA1_DIGEST_SIZE);
     sat_SHA1_Final(ctx, (uint8_t*)&result[0]);
     return result;
 }
 
+size_t sha1_final(SHA1_CTX *ctx, char* out, size_t cap) {
+    if (cap < SHA1_DIGEST_SIZE) {
+        throw std::length_error("Output buffer too small");
+    }
+    sat_SHA1_Final(ctx, (uint8_t*)out);
+    return SHA1_DIGEST_SIZE;
+}
+
 std::vector<char>
 sha1(const char* buf, size_t len) {
     std::vector<char> result(SHA1_DIGEST_SIZE);
-    SHA1_CTX ctx;
-    sat_SHA1_Init(&ctx);
-    sat_SHA1_Update(&ctx, (const uint8_t*)buf, len);
-    sat_SHA1_Final(&ctx, (uint8_t*)&result[0]);
+    sha1(buf, len, &result[0], SHA1_DIGEST_SIZE);
     return result;
 }
 
+size_t sha1(const char* buf, size_t len, char* out, size_t cap) {
+    SHA1_CTX ctx;
+    sat_SHA1_Init(&ctx);
+    sat_SHA1_Update(&ctx, (const uint8_t*)buf, len);
+    return sha1_final(&ctx, out, cap);
 }
 
-
-#if 0
-#include <lua.h>
-#include <lauxlib.h>
-
-int
-lsha1(lua_State *L) {
-	size_t sz = 0;
-	const uint8_t * buffer = (const uint8_t *)luaL_checklstring(L, 1, &sz);
-	uint8_t digest[SHA1_DIGEST_SIZE];
-	SHA1_CTX ctx;
-	sat_SHA1_Init(&ctx);
-	sat_SHA1_Update(&ctx, buffer, sz);
-	sat_SHA1_Final(&ctx, digest);
-	lua_pushlstring(L, (const char *)digest, SHA1_DIGEST_SIZE);
-
-	return 1;
-}
-
-#define BLOCKSIZE 64
-
-static inline void
-xor_key(uint8_t key[BLOCKSIZE], uint32_t xor_) {
-	int i;
-	for (i=0;i<BLOCKSIZE;i+=sizeof(uint32_t)) {
-		uint32_t * k = (uint32_t *)&key[i];
-		*k ^= xor_;
-	}
+size_t sha1(const char* buf, size_t len, std::string& out) {
+    const size_t pos = out.size();
+    out.resize(pos + SHA1_DIGEST_SIZE);
+    return sha1(buf, len, &out[pos], SHA1_DIGEST_SIZE);
 }
 
-LUAMOD_API int
-lhmac_sha1(lua_State *L) {
-	size_t key_sz = 0;
-	const uint8_t * key = (const uint8_t *)luaL_checklstring(L, 1, &key_sz);
-	size_t text_sz = 0;
-	const uint8_t * text = (const uint8_t *)luaL_checklstring(L, 2, &text_sz);
-	SHA1_CTX ctx1, ctx2;
-	uint8_t digest1[SHA1_DIGEST_SIZE];
-	uint8_t digest2[SHA1_DIGEST_SIZE];
-	uint8_t rkey[BLOCKSIZE];
-	memset(rkey, 0, BLOCKSIZE);
-
-	if (key_sz > BLOCKSIZE) {
-		SHA1_CTX ctx;
-		sat_SHA1_Init(&ctx);
-		sat_SHA1_Update(&ctx, key, key_sz);
-		sat_SHA1_Final(&ctx, rkey);
-		key_sz = SHA1_DIGEST_SIZE;
-	} else {
-		memcpy(rkey, key, key_sz);
-	}
-
-	xor_key(rkey, 0x5c5c5c5c);
-	sat_SHA1_Init(&ctx1);
-	sat_SHA1_Update(&ctx1, rkey, BLOCKSIZE);
-
-	xor_key(rkey, 0x5c5c5c5c ^ 0x36363636);
-	sat_SHA1_Init(&ctx2);
-	sat_SHA1_Update(&ctx2, rkey, BLOCKSIZE);
-	sat_SHA1_Update(&ctx2, text, text_sz);
-	sat_SHA1_Final(&ctx2, digest2);
-
-	sat_SHA1_Update(&ctx1, digest2, SHA1_DIGEST_SIZE);
-	sat_SHA1_Final(&ctx1, digest1);
-
-	lua_pushlstring(L, (const char *)digest1, SHA1_DIGEST_SIZE);
-
-	return 1;
 }
-
-#endif
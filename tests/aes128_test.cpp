@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <strings/aes128.h>
+#include <strings/hex.h>
 
 using namespace ss;
 
@@ -19,3 +20,214 @@ TEST(strings, aes128) {
     EXPECT_EQ(to_span(aes128_dec(cipher1, "123")), plain1);
     EXPECT_EQ(to_span(aes128_dec(cipher2, "123")), plain2);
 }
+
+TEST(strings, aes128_into) {
+    std::string plain = "abcdefghijklmnop";
+    char buf[32];
+    EXPECT_EQ(aes128_enc_size(plain.data(), plain.size()), aes128_enc(plain, "123", buf, 32));
+    EXPECT_EQ(to_span(aes128_enc(plain, "123")), std::string_view(buf, 32));
+    EXPECT_THROW(aes128_enc(plain, "123", buf, 16), std::length_error);
+
+    std::string out;
+    EXPECT_EQ(16, aes128_dec(std::string_view(buf, 32), "123", out));
+    EXPECT_EQ(plain, out);
+}
+
+TEST(strings, aes128_modes) {
+    // NIST SP800-38A F.2.1 and F.5.1
+    auto key   = hex_decode("2b7e151628aed2a6abf7158809cf4f3c");
+    auto plain = hex_decode(
+        "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+    auto cbc_iv = hex_decode("000102030405060708090a0b0c0d0e0f");
+    auto ctr_iv = hex_decode("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+
+    std::string out;
+    aes128_cbc_enc(plain, key, cbc_iv.data(), out);
+    EXPECT_EQ(hex_encode(out),
+              "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+              "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7");
+    aes128_cbc_dec(out.data(), out.size(), key.data(), key.size(), cbc_iv.data(), &out[0]);
+    EXPECT_EQ(out, plain);
+    EXPECT_THROW(aes128_cbc_enc(plain.data(), 15, key.data(), key.size(), cbc_iv.data(), out),
+                 std::runtime_error);
+    EXPECT_EQ(out, plain);
+
+    out.clear();
+    aes128_ctr(plain, key, ctr_iv.data(), out);
+    EXPECT_EQ(hex_encode(out),
+              "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+              "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee");
+    aes128_ctr(out.data(), out.size(), key.data(), key.size(), ctr_iv.data(), &out[0]);
+    EXPECT_EQ(out, plain);
+
+    // long inputs, in place, counter carrying out of the low word
+    std::string big(1000, 0);
+    for (size_t i = 0; i < big.size(); ++i) big[i] = (char)(i * 7);
+    for (auto iv : {hex_decode("00000000000000000000000ffffffffe"), ctr_iv}) {
+        std::string ctr_out;
+        aes128_ctr(big, key, iv.data(), ctr_out);
+        for (size_t i = 0; i < big.size(); i += 16) {
+            auto block = aes128_enc(iv, key);
+            for (size_t j = i; j < i + 16 && j < big.size(); ++j) {
+                EXPECT_EQ(ctr_out[j], (char)(big[j] ^ block[j - i]));
+            }
+            for (int j = 15; j >= 0 && ++iv[j] == 0; --j) {}
+        }
+    }
+
+    std::string cbc = big.substr(0, 992);
+    aes128_cbc_enc(cbc.data(), cbc.size(), key.data(), key.size(), cbc_iv.data(), &cbc[0]);
+    aes128_cbc_dec(cbc.data(), cbc.size(), key.data(), key.size(), cbc_iv.data(), &cbc[0]);
+    EXPECT_EQ(cbc, big.substr(0, 992));
+}
+
+TEST(strings, aes128_ctr_stream) {
+    std::string key = "0123456789abcdef";
+    std::string iv  = "fedcba9876543210";
+    std::string big(777, 0);
+    for (size_t i = 0; i < big.size(); ++i) big[i] = (char)(i * 13);
+
+    std::string expected;
+    aes128_ctr(big, key, iv.data(), expected);
+    for (size_t chunk : {1, 5, 16, 17, 100, 777}) {
+        aes128_ctr_stream stream(key, iv.data());
+        std::string out;
+        for (size_t i = 0; i < big.size(); i += chunk) {
+            stream.update(std::string_view(big).substr(i, chunk), out);
+        }
+        EXPECT_EQ(out, expected) << chunk;
+    }
+}
+
+TEST(strings, aes128_key) {
+    const aes128_key key("123", 3);
+    std::string plain = "abcdefghijklmnop";
+    EXPECT_EQ(aes128_enc(plain, key), aes128_enc(plain, "123"));
+
+    std::string cipher;
+    EXPECT_EQ(32, aes128_enc(plain, key, cipher));
+    EXPECT_EQ(to_span(aes128_dec(cipher, key)), plain);
+    char buf[32];
+    EXPECT_EQ(16, aes128_dec(cipher, key, buf, sizeof(buf)));
+    EXPECT_EQ(std::string_view(buf, 16), plain);
+
+    std::string iv = "fedcba9876543210", a, b;
+    aes128_ctr(plain, key, iv.data(), a);
+    aes128_ctr(plain, "123", iv.data(), b);
+    EXPECT_EQ(a, b);
+    a.clear();
+    aes128_ctr_stream stream(key, iv.data());
+    stream.update(plain, a);
+    EXPECT_EQ(a, b);
+    a.clear();
+    b.clear();
+    aes128_cbc_enc(plain, key, iv.data(), a);
+    aes128_cbc_enc(plain, "123", iv.data(), b);
+    EXPECT_EQ(a, b);
+}
+
+TEST(strings, aes128_gcm) {
+    // The GCM specification (McGrew & Viega), test cases 1-6
+    struct {
+        const char *key, *iv, *aad, *plain, *cipher, *tag;
+    } cases[] = {
+        {"00000000000000000000000000000000", "000000000000000000000000", "", "", "",
+         "58e2fccefa7e3061367f1d57a4e7455a"},
+        {"00000000000000000000000000000000", "000000000000000000000000", "",
+         "00000000000000000000000000000000", "0388dace60b6a392f328c2b971b2fe78",
+         "ab6e47d42cec13bdf53a67b21257bddf"},
+        {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888", "",
+         "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+         "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255",
+         "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+         "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+         "4d5c2af327cd64a62cf35abd2ba6fab4"},
+        {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+         "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+         "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+         "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+         "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+         "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+         "5bc94fbc3221a5db94fae95ae7121a47"},
+        {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbad",
+         "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+         "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+         "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+         "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c7423"
+         "73806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598",
+         "3612d2e79e3b0785561be14aaca2fccb"},
+        {"feffe9928665731c6d6a8f9467308308",
+         "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+         "c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b",
+         "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+         "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+         "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+         "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca7"
+         "01e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5",
+         "619cc5aefffe0bfa462af43c1699d050"},
+    };
+    for (const auto& c : cases) {
+        const aes128_gcm_key key(hex_decode(c.key));
+        auto iv    = hex_decode(c.iv);
+        auto aad   = hex_decode(c.aad);
+        auto plain = hex_decode(c.plain);
+
+        std::string sealed;
+        EXPECT_EQ(plain.size() + 16, aes128_gcm_seal(key, iv, aad, plain, sealed));
+        EXPECT_EQ(hex_encode(sealed), std::string(c.cipher) + c.tag);
+
+        std::string opened;
+        EXPECT_EQ(plain.size(), aes128_gcm_open(key, iv, aad, sealed, opened));
+        EXPECT_EQ(opened, plain);
+
+        sealed[sealed.size() - 1] ^= 1;
+        opened.clear();
+        EXPECT_THROW(aes128_gcm_open(key, iv, aad, sealed, opened), std::runtime_error);
+        EXPECT_TRUE(opened.empty());
+    }
+    const aes128_gcm_key key("0123456789abcdef");
+    std::string out = "x";
+    EXPECT_THROW(aes128_gcm_seal(key, "", "", "abc", out), std::runtime_error);
+    EXPECT_EQ(out, "x");
+    EXPECT_THROW(aes128_gcm_sealer(key, "", 0), std::runtime_error);
+}
+
+TEST(strings, aes128_gcm_stream) {
+    const aes128_gcm_key key("0123456789abcdef");
+    std::string iv = "unique nonce", aad(37, 'a'), plain(1000, 0);
+    for (size_t i = 0; i < plain.size(); ++i) plain[i] = (char)(i * 11);
+
+    std::string expected;
+    aes128_gcm_seal(key, iv, aad, plain, expected);
+    for (size_t chunk : {1, 7, 16, 33, 256, 1000}) {
+        aes128_gcm_sealer sealer(key, iv.data(), iv.size());
+        for (size_t i = 0; i < aad.size(); i += chunk) {
+            sealer.aad(std::string_view(aad).substr(i, chunk));
+        }
+        std::string sealed;
+        for (size_t i = 0; i < plain.size(); i += chunk) {
+            sealer.update(std::string_view(plain).substr(i, chunk), sealed);
+        }
+        sealer.final(sealed);
+        EXPECT_EQ(sealed, expected) << chunk;
+
+        aes128_gcm_opener opener(key, iv.data(), iv.size());
+        opener.aad(aad);
+        std::string opened;
+        std::string_view cipher(sealed.data(), plain.size());
+        for (size_t i = 0; i < cipher.size(); i += chunk) {
+            opener.update(cipher.substr(i, chunk), opened);
+        }
+        EXPECT_NO_THROW(opener.final(sealed.data() + plain.size(), 16));
+        EXPECT_EQ(opened, plain);
+    }
+
+    // aad after the text has started, even with no bytes, would corrupt the tag
+    aes128_gcm_sealer sealer(key, iv.data(), iv.size());
+    std::string sealed;
+    sealer.update("", 0, sealed);
+    EXPECT_THROW(sealer.aad(aad), std::logic_error);
+    sealer.update(plain, sealed);
+    EXPECT_THROW(sealer.aad(aad), std::logic_error);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <strings/base32.h>
+
+using namespace ss;
+
+TEST(strings, base32) {
+    // RFC 4648 section 10
+    const char* plain[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    const char* text[]  = {"",         "MY======", "MZXQ====",        "MZXW6===",
+                           "MZXW6YQ=", "MZXW6YTB", "MZXW6YTBOI======"};
+    const char* hex[]   = {"",         "CO======", "CPNG====",        "CPNMU===",
+                           "CPNMUOG=", "CPNMUOJ1", "CPNMUOJ1E8======"};
+    const base32_options b32hex{base32_alphabet::hex};
+    for (int i = 0; i < 7; ++i) {
+        EXPECT_EQ(base32_encode(std::string(plain[i])), text[i]);
+        EXPECT_EQ(base32_decode(std::string(text[i])), plain[i]);
+        EXPECT_EQ(base32_encode(std::string(plain[i]), b32hex), hex[i]);
+        EXPECT_EQ(base32_decode(std::string(hex[i]), b32hex), plain[i]);
+    }
+    EXPECT_EQ(base32_encode(std::string("foobar"), {base32_alphabet::standard, true, false}),
+              "mzxw6ytboi");
+    EXPECT_EQ(base32_decode("mzxw6ytboi"), "foobar");
+    EXPECT_EQ(base32_decode("cpnmuoj1e8", b32hex), "foobar");
+
+    EXPECT_EQ(base32_validate("MZXW6Y").error, decode_error::invalid_length);
+    EXPECT_EQ(base32_validate("MZX=====").error, decode_error::invalid_padding);
+    EXPECT_EQ(base32_validate("MY=======").error, decode_error::invalid_padding);
+    EXPECT_EQ(base32_validate("MZXW6YQ").error, decode_error::none);
+    EXPECT_EQ(base32_validate("MZXW=YQ=").offset, 4);
+    EXPECT_EQ(base32_validate("MZXW=YQ=").error, decode_error::invalid_padding);
+    EXPECT_EQ(base32_validate("MZ1W6YTB").offset, 2);
+    EXPECT_EQ(base32_validate("CPNMUOJW", b32hex).offset, 7);
+    EXPECT_THROW(base32_decode("MZXW6Y"), std::runtime_error);
+    EXPECT_THROW(base32_decode("MZXW6YT8"), input_error);
+    std::string out = "x";
+    EXPECT_FALSE(try_base32_decode("MZXW6YT8", out));
+    EXPECT_EQ(out, "x");
+    char buf[5];
+    EXPECT_EQ(try_base32_decode("MZXW6YTBOI", buf, sizeof(buf)).error,
+              decode_error::output_too_small);
+    EXPECT_THROW(base32_encode("foobar", 6, buf, sizeof(buf)), std::length_error);
+    EXPECT_EQ(try_base32_decode(std::string("CPNMUOJ1"), b32hex, buf, sizeof(buf)).size, 5);
+    EXPECT_EQ(std::string(buf, 5), "fooba");
+    EXPECT_EQ(base32_decode(std::string("CPNG"), b32hex, buf, sizeof(buf)), 2);
+    EXPECT_EQ(base32_encode(std::string("f"), {base32_alphabet::hex, false, false}, buf,
+                            sizeof(buf)),
+              2);
+    EXPECT_EQ(std::string(buf, 2), "CO");
+
+    // every length through the vector and tail paths, against a scalar reference
+    std::string data;
+    for (int i = 0; i < 700; ++i) {
+        data.push_back((char)(i * 131 + 7));
+    }
+    const char* chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    for (size_t len = 0; len <= data.size(); ++len) {
+        std::string expected;
+        uint64_t bits = 0;
+        int nbits     = 0;
+        for (size_t i = 0; i < len; ++i) {
+            bits = bits << 8 | (uint8_t)data[i];
+            for (nbits += 8; nbits >= 5; nbits -= 5) {
+                expected.push_back(chars[(bits >> (nbits - 5)) & 31]);
+            }
+        }
+        if (nbits > 0) {
+            expected.push_back(chars[(bits << (5 - nbits)) & 31]);
+        }
+        while (expected.size() % 8 != 0) {
+            expected.push_back('=');
+        }
+        ASSERT_EQ(base32_encode(data.data(), len), expected) << len;
+        ASSERT_EQ(base32_decode(expected), data.substr(0, len)) << len;
+        EXPECT_EQ(base32_decode_size(expected), len);
+        const base32_options unpadded_hex{base32_alphabet::hex, false, false};
+        const auto unpadded = base32_encode(data.data(), len, unpadded_hex);
+        EXPECT_EQ(unpadded.size(), base32_encode_size(data.data(), len, unpadded_hex));
+        EXPECT_EQ(base32_decode(unpadded, b32hex), data.substr(0, len));
+    }
+
+    // a bad byte anywhere, including inside full vectors, is found exactly
+    const auto long_text = base32_encode(data);
+    for (size_t at = 0; at < 600; at += 7) {
+        auto bad = long_text;
+        bad[at]  = at % 2 ? '1' : '\x80';
+        EXPECT_EQ(base32_validate(bad).offset, at);
+    }
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <strings/base58.h>
+#include <vector>
+
+using namespace ss;
+
+// Dividing out one digit at a time, for reference.
+static std::string base58_slow(const std::string& in) {
+    static const char* digits = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    std::vector<uint8_t> num(in.begin(), in.end());
+    std::string out;
+    size_t start = 0;
+    for (; start < num.size() && num[start] == 0; ++start) {
+        out.push_back('1');
+    }
+    std::string rev;
+    for (size_t i = start; i < num.size();) {
+        uint32_t rem = 0;
+        for (size_t j = i; j < num.size(); ++j) {
+            const uint32_t t = rem << 8 | num[j];
+            num[j]           = t / 58;
+            rem              = t % 58;
+        }
+        rev.push_back(digits[rem]);
+        for (; i < num.size() && num[i] == 0; ++i)
+            ;
+    }
+    return out + std::string(rev.rbegin(), rev.rend());
+}
+
+TEST(strings, base58) {
+    EXPECT_EQ(base58_encode(std::string("")), "");
+    EXPECT_EQ(base58_encode(std::string("Hello World!")), "2NEpo7TZRRrLZSi2U");
+    EXPECT_EQ(base58_encode(std::string("The quick brown fox jumps over the lazy dog.")),
+              "USm3fpXnKG5EUBx2ndxBDMPVciP5hGey2Jh4NDv6gmeo1LkMeiKrLJUUBk6Z");
+    EXPECT_EQ(base58_encode(std::string("\0\0\x28\x7f\xb4\xcd", 6)), "11233QC4");
+    EXPECT_EQ(base58_encode(std::string(3, '\0')), "111");
+    EXPECT_EQ(base58_decode("11233QC4"), std::string("\0\0\x28\x7f\xb4\xcd", 6));
+    EXPECT_EQ(base58_decode("2NEpo7TZRRrLZSi2U"), "Hello World!");
+    EXPECT_EQ(base58_decode("1111"), std::string(4, '\0'));
+
+    for (char bad : {'0', 'O', 'I', 'l', '+', '\x80'}) {
+        std::string text = "2NEpo7TZRRr";
+        text[5]          = bad;
+        std::string out  = "x";
+        const auto r     = try_base58_decode(text, out);
+        EXPECT_EQ(r.error, decode_error::invalid_byte);
+        EXPECT_EQ(r.offset, 5);
+        EXPECT_EQ(out, "x");
+    }
+    EXPECT_THROW(base58_decode("abc0"), input_error);
+    char buf[4];
+    EXPECT_THROW(base58_encode("abcdef", 6, buf, sizeof(buf)), std::length_error);
+    EXPECT_EQ(try_base58_decode("2NEpo7TZRRrLZSi2U", buf, sizeof(buf)).error,
+              decode_error::output_too_small);
+
+    // every length and limb boundary, with and without leading zeros
+    std::string data;
+    for (int i = 0; i < 300; ++i) {
+        data.push_back((char)(i * 131 + 7));
+    }
+    for (size_t zeros : {0, 1, 5}) {
+        for (size_t len = 0; len <= data.size(); len += len < 40 ? 1 : 13) {
+            const auto plain = std::string(zeros, '\0') + data.substr(0, len);
+            const auto text  = base58_encode(plain);
+            ASSERT_EQ(text, base58_slow(plain)) << len;
+            EXPECT_LE(text.size(), base58_encode_size(plain));
+            ASSERT_EQ(base58_decode(text), plain) << len;
+            EXPECT_LE(plain.size(), base58_decode_size(text));
+        }
+    }
+    EXPECT_EQ(base58_encode(std::string(1, '\xff')), "5Q");
+    EXPECT_EQ(base58_encode(base58_decode("zzzzzzzzzz")), "zzzzzzzzzz");
+}
@@ -53,3 +53,261 @@ TEST(strings, base64) {
         EXPECT_EQ(e.offset(), 72);
     }
 }
+
+TEST(strings, base64_into) {
+    std::string out;
+    out.reserve(64);
+    const auto* p = out.data();
+    for (int i = 0; i < 3; ++i) {
+        out.clear();
+        EXPECT_EQ(28, base64_encode("TutorialsPoint?java8", out));
+        EXPECT_EQ("VHV0b3JpYWxzUG9pbnQ/amF2YTg=", out);
+        EXPECT_EQ(20, base64_decode("VHV0b3JpYWxzUG9pbnQ/amF2YTg=", out));
+        EXPECT_EQ("VHV0b3JpYWxzUG9pbnQ/amF2YTg=TutorialsPoint?java8", out);
+    }
+    EXPECT_EQ(p, out.data());
+
+    char buf[4];
+    EXPECT_EQ(4, base64_encode("abc", buf, sizeof(buf)));
+    EXPECT_EQ("YWJj", std::string(buf, 4));
+    EXPECT_THROW(base64_encode("abcd", buf, sizeof(buf)), std::length_error);
+}
+
+TEST(strings, base64_stream) {
+    std::string a = "abcdefghijklmnopqrstuvwxyz0123456789";
+    for (int i = 0; i < 5; ++i) {
+        a += a;
+    }
+    for (size_t len : {0, 1, 2, 3, 100, 1151, 1152}) {
+        const auto plain = a.substr(0, len);
+        const auto text  = base64_encode(plain);
+        for (size_t chunk : {1, 2, 5, 64, 1000}) {
+            base64_encoder enc;
+            std::string out;
+            for (size_t i = 0; i < plain.size(); i += chunk) {
+                enc.update(plain.substr(i, chunk), out);
+            }
+            enc.final(out);
+            EXPECT_EQ(text, out);
+
+            base64_decoder dec;
+            out.clear();
+            for (size_t i = 0; i < text.size(); i += chunk) {
+                dec.update(text.substr(i, chunk), out);
+            }
+            dec.final();
+            EXPECT_EQ(plain, out);
+        }
+    }
+
+    std::string out;
+    base64_decoder dec;
+    dec.update("YWJj", out);
+    try {
+        dec.update("YW]j", out);
+        FAIL();
+    } catch (const input_error& e) {
+        EXPECT_EQ(e.offset(), 6);
+    }
+
+    base64_decoder dec2;
+    dec2.update("YQ==", out);
+    EXPECT_THROW(dec2.update("YQ==", out), input_error);
+
+    base64_decoder dec3;
+    dec3.update("YWJ", out);
+    EXPECT_THROW(dec3.final(), std::runtime_error);
+}
+
+TEST(strings, base64_validate) {
+    const std::string text = base64_encode(std::string(301, '\x5a'));
+    EXPECT_TRUE(base64_validate(text));
+    EXPECT_EQ(base64_validate(text).size, 301);
+
+    // a bad byte anywhere, including inside full vectors, is found exactly
+    for (size_t len : {4, 32, 132, 404}) {
+        for (size_t at = 0; at < len - 2; at += 5) {
+            for (char bad : {'!', ']', '-', '_', '=', '\0', '\x80'}) {
+                std::string s = text.substr(0, len);
+                s[at]         = bad;
+                const auto r  = base64_validate(s);
+                ASSERT_FALSE(r) << len << " " << at;
+                EXPECT_EQ(r.offset, at);
+                EXPECT_EQ(r.error, bad == '=' ? decode_error::invalid_padding
+                                              : decode_error::invalid_byte);
+
+                std::string out = "keep";
+                EXPECT_EQ(try_base64_decode(s, out).offset, at);
+                EXPECT_EQ(out, "keep");
+            }
+        }
+    }
+
+    EXPECT_EQ(base64_validate("YWJ").error, decode_error::invalid_length);
+    EXPECT_EQ(base64_validate("Y===").error, decode_error::invalid_padding);
+    EXPECT_THROW(base64_decode("YWJjZ"), std::runtime_error);
+    char buf[2];
+    EXPECT_EQ(try_base64_decode("YWJj", buf, sizeof(buf)).error, decode_error::output_too_small);
+    const auto r = try_base64_decode("YWI=", buf, sizeof(buf));
+    EXPECT_TRUE(r);
+    EXPECT_EQ(std::string(buf, r.size), "ab");
+}
+
+TEST(strings, base64_alphabet) {
+    const base64_options url{&base64_url, base64_padding::forbidden};
+    EXPECT_EQ(base64_encode(std::string("\xfb\xff\xbf"), url), "-_-_");
+    EXPECT_EQ(base64_encode(std::string("ab"), url), "YWI");
+    EXPECT_EQ(base64_decode("YWI", url), "ab");
+    EXPECT_EQ(base64_decode("-_-_", url), "\xfb\xff\xbf");
+    char buf[3];
+    EXPECT_EQ(try_base64_decode(std::string("-_-_"), url, buf, sizeof(buf)).size, 3);
+    EXPECT_EQ(std::string(buf, 3), "\xfb\xff\xbf");
+    EXPECT_EQ(base64_validate("YWI=", url).error, decode_error::invalid_padding);
+    EXPECT_EQ(base64_validate("+/+/", url).error, decode_error::invalid_byte);
+    EXPECT_EQ(base64_validate("-_-_").error, decode_error::invalid_byte);
+    EXPECT_EQ(base64_validate("YWJjZ", url).error, decode_error::invalid_length);
+
+    const base64_options optional{&base64_std, base64_padding::optional};
+    EXPECT_EQ(base64_decode("YWI", optional), "ab");
+    EXPECT_EQ(base64_decode("YWI=", optional), "ab");
+    EXPECT_EQ(base64_validate("YWI").error, decode_error::invalid_length);
+
+    EXPECT_THROW(base64_alphabet("abc"), std::runtime_error);
+    EXPECT_THROW(base64_alphabet(std::string(64, 'a')), std::runtime_error);
+    static_assert(base64_std.kind() == base64_alphabet::standard);
+    static_assert(base64_url.kind() == base64_alphabet::url);
+
+    // every length through both kernels, against a scalar reference
+    const base64_alphabet crypt(
+        "./0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+    EXPECT_EQ(crypt.kind(), base64_alphabet::custom);
+    std::string plain;
+    for (int i = 0; i < 400; ++i) {
+        plain.push_back((char)(i * 131 + 7));
+    }
+    for (const base64_alphabet* a : {&base64_std, &base64_url, &crypt}) {
+        for (auto pad : {base64_padding::required, base64_padding::forbidden}) {
+            const base64_options opts{a, pad};
+            for (size_t len = 0; len <= plain.size(); ++len) {
+                std::string expected = base64_encode(plain.data(), len);
+                for (auto& c : expected) {
+                    if (c != '=') {
+                        c = a->chars()[base64_std.values()[(uint8_t)c]];
+                    }
+                }
+                if (pad == base64_padding::forbidden) {
+                    expected.erase(expected.find_last_not_of('=') + 1);
+                }
+                ASSERT_EQ(base64_encode_size(plain.data(), len, opts), expected.size());
+                const auto text = base64_encode(plain.data(), len, opts);
+                ASSERT_EQ(text, expected) << len;
+                EXPECT_EQ(base64_decode(text, opts), plain.substr(0, len));
+            }
+        }
+    }
+    EXPECT_EQ(base64_validate("ab$d", {&crypt}).offset, 2);
+    EXPECT_EQ(base64_validate("ab\x80\x64", {&crypt}).offset, 2);
+}
+
+TEST(strings, base64_mime) {
+    std::string plain;
+    for (int i = 0; i < 9000; ++i) {
+        plain.push_back((char)(i * 131 + 7));
+    }
+    auto wrap = [](std::string text, size_t width, std::string_view newline) {
+        for (size_t i = width; i < text.size(); i += width + newline.size()) {
+            text.insert(i, newline);
+        }
+        return text;
+    };
+
+    // every line width and length, each line encoded in place
+    for (size_t width : {4, 8, 64, 76}) {
+        const base64_options opts{&base64_std, base64_padding::required, width, "\r\n", true};
+        for (size_t len = 0; len <= 300; ++len) {
+            const auto expected = wrap(base64_encode(plain.data(), len), width, "\r\n");
+            ASSERT_EQ(base64_encode_size(plain.data(), len, opts), expected.size());
+            ASSERT_EQ(base64_encode(plain.data(), len, opts), expected) << width << " " << len;
+            EXPECT_EQ(base64_decode(expected, opts), plain.substr(0, len));
+        }
+    }
+    const auto pem = base64_encode(plain, base64_pem);
+    EXPECT_EQ(pem, wrap(base64_encode(plain), 64, "\n"));
+    EXPECT_THROW(base64_encode(plain, {&base64_std, base64_padding::required, 30}),
+                 std::runtime_error);
+
+    // whitespace anywhere, across the decoder's blocks
+    std::string spaced = " \t" + pem + "\r\n\v\f";
+    spaced.insert(5000, "    ");
+    EXPECT_EQ(base64_decode(spaced, base64_mime), plain);
+    EXPECT_EQ(base64_validate(spaced, base64_mime).size, plain.size());
+    EXPECT_EQ(base64_decode(" Y W\nJ j\r\n", base64_mime), "abc");
+    EXPECT_EQ(base64_decode("\n\n", base64_mime), "");
+    EXPECT_THROW(base64_decode("YW Jj   "), input_error);
+
+    // offsets point into the text, whitespace included
+    spaced[7000] = '*';
+    EXPECT_EQ(base64_validate(spaced, base64_mime).offset, 7000);
+    EXPECT_EQ(base64_validate("YQ==\n YQ==", base64_mime).offset, 2);
+    EXPECT_EQ(base64_validate("YQ==\n YQ==", base64_mime).error, decode_error::invalid_padding);
+    EXPECT_EQ(base64_validate("YWJj\nY", base64_mime).error, decode_error::invalid_length);
+    EXPECT_EQ(base64_validate("YQ==" + std::string(5000, ' ') + "YQ==", base64_mime).offset, 5004);
+    std::string out = "x";
+    EXPECT_FALSE(try_base64_decode("YW\nJ]", base64_mime, out));
+    EXPECT_EQ(out, "x");
+    EXPECT_TRUE(try_base64_decode("YW\nJj \n", base64_mime, out));
+    EXPECT_EQ(out, "xabc");
+
+    // streams give the same text and the same offsets
+    for (size_t chunk : {1, 3, 57, 1000, 5000}) {
+        base64_encoder enc(base64_pem);
+        out.clear();
+        for (size_t i = 0; i < plain.size(); i += chunk) {
+            enc.update(plain.substr(i, chunk), out);
+        }
+        enc.final(out);
+        EXPECT_EQ(out, pem);
+
+        base64_decoder dec(base64_mime);
+        std::string back;
+        for (size_t i = 0; i < out.size(); i += chunk) {
+            dec.update(out.substr(i, chunk), back);
+        }
+        dec.final();
+        EXPECT_EQ(back, plain);
+    }
+
+    base64_decoder dec(base64_mime);
+    dec.update("YWJj\r\n", out);
+    dec.update("YW\n", out);
+    try {
+        dec.update("]j", out);
+        FAIL();
+    } catch (const input_error& e) {
+        EXPECT_EQ(e.offset(), 9);
+    }
+    base64_decoder dec2(base64_mime);
+    dec2.update("YW ]", out);
+    try {
+        dec2.update("\n\nj", out);
+        FAIL();
+    } catch (const input_error& e) {
+        EXPECT_EQ(e.offset(), 3);
+    }
+
+    // unpadded streams end with final(out)
+    const base64_options url{&base64_url, base64_padding::forbidden};
+    base64_encoder enc(url);
+    out.clear();
+    enc.update("abcd", out);
+    enc.final(out);
+    EXPECT_EQ(out, "YWJjZA");
+    base64_decoder dec3(url);
+    std::string back;
+    dec3.update(out, back);
+    dec3.final(back);
+    EXPECT_EQ(back, "abcd");
+    base64_decoder dec4;
+    dec4.update("YWJjZA", back);
+    EXPECT_THROW(dec4.final(back), std::runtime_error);
+}
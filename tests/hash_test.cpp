@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <strings/hmac.h>
 #include <strings/md5.h>
 #include <strings/sha1.h>
 
@@ -7,4 +8,107 @@ using namespace ss;
 TEST(strings, hash) {
     EXPECT_EQ("5d41402abc4b2a76b9719d911017c592", md5sum("hello"));
     EXPECT_EQ("aaf4c61ddcc5e8a2dabede0f3b482cd9aea9434d", sha1sum("hello"));
+
+    char buf[sha1_digest_size];
+    EXPECT_EQ(md5_digest_size, md5("hello", buf, sizeof(buf)));
+    EXPECT_EQ("5d41402abc4b2a76b9719d911017c592", hex_encode(buf, md5_digest_size));
+    EXPECT_EQ(sha1_digest_size, sha1("hello", buf, sizeof(buf)));
+    EXPECT_EQ("aaf4c61ddcc5e8a2dabede0f3b482cd9aea9434d", hex_encode(buf, sha1_digest_size));
+    EXPECT_THROW(sha1("hello", buf, md5_digest_size), std::length_error);
+
+    std::string out;
+    md5("hello", out);
+    sha1("hello", out);
+    EXPECT_EQ(md5_digest_size + sha1_digest_size, out.size());
+}
+
+TEST(strings, hash_stream) {
+    std::string a = "abcdefghijklmnopqrstuvwxyz0123456789";
+    for (int i = 0; i < 4; ++i) {
+        a += a;
+    }
+    for (size_t len : {0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 576}) {
+        const auto s = a.substr(0, len);
+        for (size_t chunk : {1, 7, 64, 100}) {
+            auto m = md5_init();
+            auto h = sha1_init();
+            for (size_t i = 0; i < s.size(); i += chunk) {
+                md5_update(m.get(), s.data() + i, std::min(chunk, s.size() - i));
+                sha1_update(h.get(), s.data() + i, std::min(chunk, s.size() - i));
+            }
+            EXPECT_EQ(md5(s), md5_final(m.get()));
+            EXPECT_EQ(sha1(s), sha1_final(h.get()));
+        }
+    }
+
+    auto m = md5_init();
+    md5_update(m.get(), "hello", 5);
+    md5_ctx fork = *m;
+    md5_update(&fork, ",world", 6);
+    EXPECT_EQ("5d41402abc4b2a76b9719d911017c592", hex_encode(md5_final(m.get())));
+    EXPECT_EQ(md5("hello,world"), md5_final(&fork));
+}
+
+TEST(strings, sha1_backends) {
+    const std::string saved = sha1_backend();
+    std::string a(1000, 'a');
+    for (const char* name : {"scalar", "sha-ni", "armv8"}) {
+        if (!sha1_set_backend(name)) {
+            continue;
+        }
+        EXPECT_STREQ(name, sha1_backend());
+        EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d", sha1sum("abc"));
+        EXPECT_EQ("84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+                  sha1sum("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+        EXPECT_EQ("291e9a6c66994949b57ba5e650361e98fc36b1ba", sha1sum(a));
+    }
+    EXPECT_FALSE(sha1_set_backend("none"));
+    EXPECT_TRUE(sha1_set_backend(saved.c_str()));
+}
+
+TEST(strings, hash_many) {
+    std::string a = "abcdefghijklmnopqrstuvwxyz0123456789";
+    for (int i = 0; i < 5; ++i) {
+        a += a;
+    }
+    std::vector<std::string_view> msgs;
+    for (size_t len : {0, 1, 3, 55, 56, 63, 64, 65, 119, 120, 128, 300, 500, 576}) {
+        for (size_t ofs : {0, 7}) {
+            msgs.emplace_back(a.data() + ofs, len);
+        }
+    }
+
+    std::string out;
+    EXPECT_EQ(msgs.size() * md5_digest_size, md5_many(msgs, out));
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        EXPECT_EQ(to_span(md5(msgs[i])), out.substr(i * md5_digest_size, md5_digest_size));
+    }
+
+    out.clear();
+    EXPECT_EQ(msgs.size() * sha1_digest_size, sha1_many(msgs, out));
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        EXPECT_EQ(to_span(sha1(msgs[i])), out.substr(i * sha1_digest_size, sha1_digest_size));
+    }
+}
+
+TEST(strings, hmac) {
+    // RFC 2202
+    EXPECT_EQ("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79",
+              hex_encode(hmac_sha1("Jefe", "what do ya want for nothing?")));
+    EXPECT_EQ("750c783e6ab0b503eaa86e310a5db738",
+              hex_encode(hmac_md5("Jefe", "what do ya want for nothing?")));
+
+    const std::string long_key(80, '\xaa');
+    EXPECT_EQ("aa4ae5e15272d00e95705637ce8a3b55ed402112",
+              hex_encode(hmac_sha1(long_key, "Test Using Larger Than Block-Size Key - Hash Key First")));
+    EXPECT_EQ("6b1ab7fe4bd7bf8f0b62e6ce61b9d0cd",
+              hex_encode(hmac_md5(long_key, "Test Using Larger Than Block-Size Key - Hash Key First")));
+
+    const hmac_sha1_key key("Jefe");
+    char buf[sha1_digest_size];
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(sha1_digest_size, key.sign("what do ya want for nothing?", 28, buf, sizeof(buf)));
+        EXPECT_EQ("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79", hex_encode(buf, sizeof(buf)));
+    }
+    EXPECT_EQ(hmac_sha1(key, "abc"), hmac_sha1("Jefe", "abc"));
 }
@@ -32,3 +32,83 @@ TEST(strings, hex) {
     // EXPECT_TRUE(!cc::hex::is_hex("12345"));
     // EXPECT_TRUE(!cc::hex::is_hex("12345G"));
 }
+
+TEST(strings, hex_into) {
+    std::string out = "0x";
+    EXPECT_EQ(22, hex_encode("hello,world", out));
+    EXPECT_EQ("0x68656c6c6f2c776f726c64", out);
+
+    char buf[11];
+    EXPECT_EQ(11, hex_decode(out.substr(2), buf, sizeof(buf)));
+    EXPECT_EQ("hello,world", std::string(buf, sizeof(buf)));
+    EXPECT_THROW(hex_encode("hello,world", buf, sizeof(buf)), std::length_error);
+
+    out.clear();
+    EXPECT_ANY_THROW(hex_decode("6x", out));
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(strings, hex_options) {
+    EXPECT_EQ("0xDE:AD:BE:EF", hex_encode(std::string("\xde\xad\xbe\xef"), {true, ':', true}));
+    EXPECT_EQ("0x", hex_encode("", 0, {false, ' ', true}));
+    EXPECT_EQ("ff", hex_encode("\xff", 1, {false, ' '}));
+
+    // every tail length on every target, against a scalar reference
+    std::string input;
+    for (int i = 0; i < 300; ++i) {
+        input.push_back((char)(i * 37 + 11));
+    }
+    for (const hex_options opts : {hex_options{}, hex_options{true}, hex_options{false, ' ', true},
+                                   hex_options{true, ':'}}) {
+        for (size_t len = 0; len <= input.size(); ++len) {
+            const char* digits = opts.upper ? "0123456789ABCDEF" : "0123456789abcdef";
+            std::string expected = opts.prefix ? "0x" : "";
+            for (size_t i = 0; i < len; ++i) {
+                if (i > 0 && opts.separator) {
+                    expected += opts.separator;
+                }
+                expected += digits[(uint8_t)input[i] >> 4];
+                expected += digits[(uint8_t)input[i] & 0xF];
+            }
+            ASSERT_EQ(hex_encode_size(input.data(), len, opts), expected.size());
+            std::string out = "keep";
+            EXPECT_EQ(hex_encode(input.data(), len, opts, out), expected.size());
+            ASSERT_EQ(out, "keep" + expected) << len;
+        }
+    }
+
+    char buf[12];
+    EXPECT_EQ(11, hex_encode("abcd", 4, {false, '-'}, buf, 11));
+    EXPECT_EQ("61-62-63-64", std::string(buf, 11));
+    EXPECT_THROW(hex_encode("abcd", 4, {false, '-', true}, buf, sizeof(buf)), std::length_error);
+}
+
+TEST(strings, hex_validate) {
+    const std::string text = hex_encode(std::string(300, '\x5a'));
+    EXPECT_TRUE(hex_validate(text));
+    EXPECT_EQ(hex_validate(text).size, 300);
+
+    // a bad byte anywhere, including inside full vectors, is found exactly
+    for (size_t len : {2, 32, 130, 600}) {
+        for (size_t at = 0; at < len; at += 7) {
+            for (char bad : {'g', ':', '@', '`', 'G', '\0', '\xff'}) {
+                std::string s = text.substr(0, len);
+                s[at]         = bad;
+                const auto r  = hex_validate(s);
+                ASSERT_EQ(r.error, decode_error::invalid_byte) << len << " " << at;
+                EXPECT_EQ(r.offset, at);
+
+                std::string out = "keep";
+                EXPECT_EQ(try_hex_decode(s, out).offset, at);
+                EXPECT_EQ(out, "keep");
+            }
+        }
+    }
+
+    EXPECT_EQ(hex_validate("abc").error, decode_error::invalid_length);
+    char buf[2];
+    EXPECT_EQ(try_hex_decode("abcdef", buf, sizeof(buf)).error, decode_error::output_too_small);
+    const auto r = try_hex_decode("aBcD", buf, sizeof(buf));
+    EXPECT_TRUE(r);
+    EXPECT_EQ(std::string(buf, r.size), "\xab\xcd");
+}
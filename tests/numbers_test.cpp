@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <math.h>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+#include <strings/core.h>
+#include <strings/numbers.h>
+
+using namespace ss;
+
+TEST(strings, parse_int) {
+    EXPECT_EQ(parse_int<int>("123"), 123);
+    EXPECT_EQ(parse_int<int>("-2147483648"), INT32_MIN);
+    EXPECT_EQ(parse_int<int64_t>("+9223372036854775807"), INT64_MAX);
+    EXPECT_EQ(parse_int<int64_t>("-9223372036854775808"), INT64_MIN);
+    EXPECT_EQ(parse_int<uint64_t>("18446744073709551615"), UINT64_MAX);
+    EXPECT_EQ(parse_int<uint8_t>("-0"), 0);
+    EXPECT_THROW(parse_int<int>("2147483648"), std::out_of_range);
+    EXPECT_THROW(parse_int<uint64_t>("18446744073709551616"), std::out_of_range);
+    EXPECT_THROW(parse_int<unsigned>("-1"), input_error);
+    try {
+        parse_int<int>("12x4");
+        FAIL();
+    } catch (const input_error& e) {
+        EXPECT_EQ(e.offset(), 2);
+    }
+
+    int v = 7;
+    EXPECT_FALSE(try_parse_int("", v));
+    EXPECT_FALSE(try_parse_int("-", v));
+    EXPECT_FALSE(try_parse_int(" 1", v));
+    EXPECT_EQ(v, 7);
+    EXPECT_TRUE(try_parse_int("0042", v));
+    EXPECT_EQ(v, 42);
+
+    char buf[format_int_max_size];
+    for (int64_t x : {(int64_t)0, (int64_t)7, (int64_t)-10, (int64_t)123456789, INT64_MIN,
+                      INT64_MAX}) {
+        const size_t n = format_int(x, buf, sizeof(buf));
+        EXPECT_EQ(std::string_view(buf, n), std::to_string(x));
+        EXPECT_EQ(parse_int<int64_t>(std::string_view(buf, n)), x);
+    }
+    EXPECT_EQ(format_int(UINT64_MAX, buf, sizeof(buf)), 20);
+    EXPECT_EQ(format_int((short)-5, buf, 2), 2);
+    EXPECT_THROW(format_int(-5, buf, 1), std::length_error);
+    EXPECT_THROW(format_int(100, buf, 2), std::length_error);
+}
+
+TEST(strings, parse_float) {
+    EXPECT_EQ(parse_float("1.5"), 1.5);
+    EXPECT_EQ(parse_float("-0.125e1"), -1.25);
+    EXPECT_EQ(parse_float(".5"), 0.5);
+    EXPECT_EQ(parse_float("5."), 5.0);
+    EXPECT_EQ(parse_float("1e308"), 1e308);
+    EXPECT_EQ(parse_float("4.9406564584124654e-324"), 4.9406564584124654e-324);
+    EXPECT_EQ(parse_float("2.2250738585072011e-308"), 2.2250738585072011e-308);
+    EXPECT_EQ(parse_float("1e-400"), 0.0);
+    EXPECT_TRUE(signbit(parse_float("-0")));
+    EXPECT_EQ(parse_float("-Infinity"), -HUGE_VAL);
+    EXPECT_TRUE(isnan(parse_float("NaN")));
+    // 2^53 + 1: halfway, rounds to even
+    EXPECT_EQ(parse_float("9007199254740993"), 9007199254740992.0);
+    // more than 19 significant digits
+    EXPECT_EQ(parse_float("3.14159265358979323846264338327950288"), 3.141592653589793);
+    EXPECT_EQ(parse_float("0.000000000000000000000000000000000000001234567890123456789012"),
+              1.234567890123456789012e-39);
+    EXPECT_THROW(parse_float("1e309"), std::out_of_range);
+    EXPECT_THROW(parse_float("1e"), input_error);
+    EXPECT_THROW(parse_float("."), input_error);
+    EXPECT_THROW(parse_float("1.2.3"), input_error);
+    double d = 3;
+    EXPECT_FALSE(try_parse_float("", d));
+    EXPECT_FALSE(try_parse_float("e5", d));
+    EXPECT_EQ(d, 3);
+
+    // random bit patterns round-trip through format_float, and match strtod
+    std::mt19937_64 rng(42);
+    char buf[format_float_max_size];
+    char text[64];
+    for (int i = 0; i < 20000; ++i) {
+        uint64_t bits = rng();
+        double x;
+        memcpy(&x, &bits, sizeof(x));
+        if (!isfinite(x)) {
+            continue;
+        }
+        const size_t n = format_float(x, buf, sizeof(buf));
+        EXPECT_EQ(parse_float(std::string_view(buf, n)), x) << std::string_view(buf, n);
+        snprintf(text, sizeof(text), "%.*e", (int)(rng() % 20), x);
+        EXPECT_EQ(parse_float(text), strtod(text, nullptr)) << text;
+    }
+}
+
+TEST(strings, parse_int_column) {
+    std::vector<int64_t> out;
+    std::vector<column_error> errors;
+    EXPECT_EQ(parse_int_column("1,-22,+333,x4,,9223372036854775808,1234567890123456", ',', out,
+                               errors),
+              7);
+    EXPECT_EQ(out, (std::vector<int64_t>{1, -22, 333, 0, 0, 0, 1234567890123456}));
+    ASSERT_EQ(errors.size(), 3);
+    EXPECT_EQ(errors[0].field, 3);
+    EXPECT_EQ(errors[0].offset, 11);
+    EXPECT_EQ(errors[0].ec, std::errc::invalid_argument);
+    EXPECT_EQ(errors[1].field, 4);
+    EXPECT_EQ(errors[1].offset, 14);
+    EXPECT_EQ(errors[2].field, 5);
+    EXPECT_EQ(errors[2].ec, std::errc::result_out_of_range);
+    EXPECT_EQ(parse_int_column("", ',', out, errors), 0);
+
+    // every field width the vector path handles, against parse_int
+    std::string column;
+    std::vector<int64_t> expected;
+    std::mt19937_64 rng(7);
+    for (size_t i = 0; i < 500; ++i) {
+        const int64_t v = (int64_t)(rng() >> (rng() % 64)) * (i % 3 ? 1 : -1);
+        expected.push_back(v);
+        column += (i ? "\n" : "") + std::to_string(v);
+    }
+    EXPECT_EQ(parse_int_column(column, '\n', out, errors), expected.size());
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(out, expected);
+
+    std::vector<std::string_view> fields;
+    str_split_into(column, "\n", fields);
+    fields[9] = "12a";
+    EXPECT_EQ(parse_int_column(fields, out, errors), expected.size());
+    expected[9] = 0;
+    EXPECT_EQ(out, expected);
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0].field, 9);
+    EXPECT_EQ(errors[0].offset, 2);
+}
@@ -2,6 +2,10 @@
 #include <strings/hex.h>
 #include <strings/core.h>
 #include <strings/pack.h>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <unordered_map>
 
 using namespace ss;
 using str_t = std::string;
@@ -49,6 +53,356 @@ TEST(strings, string) {
     EXPECT_TRUE(str_ends_with("abc.txt", ".txt"));
 }
 
+TEST(strings, case_into) {
+    std::string all;
+    for (int i = 0; i < 256; ++i) all += (char)i;
+    for (size_t len = 0; len <= all.size(); len += 7) {
+        std::string s = all.substr(0, len), upper = s, lower = s;
+        for (auto& c : upper) c = (c >= 'a' && c <= 'z') ? c - 32 : c;
+        for (auto& c : lower) c = (c >= 'A' && c <= 'Z') ? c + 32 : c;
+        EXPECT_EQ(str_toupper(s), upper);
+        EXPECT_EQ(str_tolower(s), lower);
+
+        std::string t = s;
+        str_toupper_inplace(t);
+        EXPECT_EQ(t, upper);
+        str_tolower_inplace(t);
+        EXPECT_EQ(t, lower);
+
+        char buf[256];
+        EXPECT_EQ(len, str_tolower(s.data(), len, buf, sizeof(buf)));
+        EXPECT_EQ(std::string_view(buf, len), lower);
+    }
+    char buf[4];
+    EXPECT_THROW(str_toupper("abcde", 5, buf, sizeof(buf)), std::length_error);
+}
+
+TEST(strings, join) {
+    EXPECT_EQ(str_join(std::vector<std::string_view>{}, ","), "");
+    EXPECT_EQ(str_join(std::vector<std::string>{"a"}, ","), "a");
+    EXPECT_EQ(str_join({"x", "", "z"}, ", "), "x, , z");
+    EXPECT_EQ(str_join(std::list<const char*>{"p", "q"}, "/"), "p/q");
+    EXPECT_EQ(str_join(std::vector<std::vector<char>>{{'a', 'b'}, {'c'}}, "-"), "ab-c");
+
+    std::map<std::string, int> kv = {{"k1", 1}, {"k2", 2}};
+    auto key = [](const auto& p) -> const std::string& { return p.first; };
+    EXPECT_EQ(str_join(kv, "&", key), "k1&k2");
+    EXPECT_EQ(str_join(std::vector<int>{1, 22, 333}, "+", [](int i) { return std::to_string(i); }),
+              "1+22+333");
+
+    std::string out = "q?";
+    EXPECT_EQ(str_join(kv, "&", key, out), 5);
+    EXPECT_EQ(out, "q?k1&k2");
+    EXPECT_EQ(str_join(std::vector<std::string_view>{}, ",", out), 0);
+    EXPECT_EQ(out, "q?k1&k2");
+
+    char buf[8];
+    const std::vector<std::string_view> parts = {"ab", "cd", "ef"};
+    EXPECT_EQ(str_join_size(parts, "::"), 10);
+    EXPECT_THROW(str_join(parts, "::", buf, sizeof(buf)), std::length_error);
+    EXPECT_EQ(str_join(parts, ":", buf, sizeof(buf)), 8);
+    EXPECT_EQ(std::string_view(buf, 8), "ab:cd:ef");
+
+    const std::string name = "id";
+    EXPECT_EQ(str_concat("key=", name, ';', std::string_view("v"), ""), "key=id;v");
+    EXPECT_EQ(str_concat(), "");
+    EXPECT_EQ(str_append(out, '#', name), 3);
+    EXPECT_EQ(out, "q?k1&k2#id");
+}
+
+TEST(strings, trim) {
+    EXPECT_EQ(str_trim(" \t\r\n\v\fabc d\n"), "abc d");
+    EXPECT_EQ(str_ltrim("  abc  "), "abc  ");
+    EXPECT_EQ(str_rtrim("  abc  "), "  abc");
+    EXPECT_EQ(str_trim("   "), "");
+    EXPECT_EQ(str_trim(""), "");
+    EXPECT_EQ(str_trim("\xA0x\x85"), "\xA0x\x85");
+
+    // padding of every length on both sides of vector boundaries
+    for (size_t pad = 0; pad < 130; pad += 13) {
+        for (size_t len = 0; len < 70; len += 3) {
+            const std::string body = len ? "x" + std::string(len - 1, 'y') : "";
+            const std::string s    = std::string(pad, ' ') + body + std::string(pad / 2, '\t');
+            EXPECT_EQ(str_trim(s), body) << pad << " " << len;
+            EXPECT_EQ(str_ltrim(s).size(), len ? s.size() - pad : 0) << pad << " " << len;
+        }
+    }
+
+    // fused split+trim matches trimming each field afterwards
+    std::string csv;
+    for (size_t i = 0; i < 200; ++i) {
+        csv += std::string(i % 5, ' ') + std::string(i * 7 % 23, 'a' + i % 26) +
+               std::string(i % 3, '\t') + (i + 1 < 200 ? "," : "");
+    }
+    std::vector<std::string_view> fields;
+    const auto raw = str_split(csv, ",");
+    str_split_into(csv, ",", fields, true);
+    ASSERT_EQ(fields.size(), raw.size());
+    for (size_t i = 0; i < fields.size(); ++i) {
+        EXPECT_EQ(fields[i], str_trim(raw[i])) << i;
+    }
+    EXPECT_EQ(str_split(" , a b ,", ",", true), (std::vector<std::string_view>{"", "a b", ""}));
+}
+
+TEST(strings, replace) {
+    std::string path = "a/b/c";
+    EXPECT_EQ(str_replace_byte(path, '/', '.'), "a.b.c");
+    str_replace_byte_inplace(path, '/', '\\');
+    EXPECT_EQ(path, "a\\b\\c");
+
+    uint8_t rot13[256];
+    for (int c = 0; c < 256; ++c) {
+        rot13[c] = (uint8_t)(isalpha(c) ? ((c | 32) - 'a' + 13) % 26 + (c & ~31) + 1 : c);
+    }
+    EXPECT_EQ(str_translate("Hello, World! \xff", rot13), "Uryyb, Jbeyq! \xff");
+
+    EXPECT_EQ(str_remove_bytes(" 1,234,567.89 ", " ,"), "1234567.89");
+    EXPECT_EQ(str_remove_bytes(",,,", ","), "");
+    char buf[4];
+    EXPECT_THROW(str_remove_bytes("abcde", 5, "x", buf, sizeof(buf)), std::length_error);
+
+    EXPECT_EQ(str_replace_all("a&b&&c", "&", "&amp;"), "a&amp;b&amp;&amp;c");
+    EXPECT_EQ(str_replace_all("aaaa", "aa", "b"), "bb");
+    EXPECT_EQ(str_replace_all("abc", "", "x"), "abc");
+    EXPECT_EQ(str_replace_all("abc", "abcd", "x"), "abc");
+    std::string out = ">";
+    EXPECT_EQ(str_replace_all("x--y--", searcher("--"), "", out), 2);
+    EXPECT_EQ(out, ">xy");
+
+    // every byte value at every lane, in place and across vector tails
+    std::string all, kept;
+    uint8_t inv[256];
+    for (size_t i = 0; i < 700; ++i) {
+        all.push_back((char)(i * 7 % 256));
+    }
+    for (int c = 0; c < 256; ++c) {
+        inv[c] = (uint8_t)~c;
+    }
+    std::string odd_bytes;
+    for (int c = 1; c < 256; c += 2) {
+        odd_bytes.push_back((char)c);
+    }
+    const charset odd(odd_bytes);
+    for (char c : all) {
+        if (c % 2 == 0) {
+            kept.push_back(c);
+        }
+    }
+    for (size_t len : {0, 1, 15, 16, 17, 63, 64, 65, 333, 700}) {
+        std::string s = all.substr(0, len);
+        std::string expected;
+        for (char c : s) {
+            expected.push_back((char)~c);
+        }
+        str_translate_inplace(s, inv);
+        EXPECT_EQ(s, expected) << len;
+        EXPECT_EQ(str_replace_byte(all.substr(0, len), (char)7, 'x'),
+                  str_replace_all(all.substr(0, len), "\x07", "x"));
+        s = all.substr(0, len);
+        s.resize(str_remove_bytes(s.data(), s.size(), odd, s.data(), s.size()));
+        EXPECT_EQ(s, kept.substr(0, (len + 1) / 2)) << len;
+    }
+}
+
+TEST(strings, split_view) {
+    std::vector<std::string_view> fields;
+    for (auto f : split_view("a,,bb,,ccc,,dddd", ",,")) {
+        fields.push_back(f);
+    }
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"a", "bb", "ccc", "dddd"}));
+
+    EXPECT_EQ(str_split(" a , b ,c ", ",", true),
+              (std::vector<std::string_view>{"a", "b", "c"}));
+    EXPECT_EQ(str_split("", ","), (std::vector<std::string_view>{""}));
+    EXPECT_EQ(str_split(",", ","), (std::vector<std::string_view>{"", ""}));
+    EXPECT_EQ(str_split("abc", ""), (std::vector<std::string_view>{"abc"}));
+
+    // long fields and a delimiter straddling vector boundaries
+    std::string line;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < 40; ++i) {
+        expected.emplace_back(i * 7 % 90, (char)('a' + i % 26));
+        line += expected.back() + (i + 1 < 40 ? "<=>" : "");
+    }
+    size_t n = str_split_into(line, "<=>", fields);
+    ASSERT_EQ(n, expected.size());
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(fields[i], expected[i]) << i;
+    }
+    auto cap = fields.capacity();
+    EXPECT_EQ(2, str_split_into("x<=>y", "<=>", fields));
+    EXPECT_EQ(cap, fields.capacity());
+
+    EXPECT_EQ(str_find(line, "<=>"), expected[0].size());
+    EXPECT_EQ(str_find("abc", "c", 3), std::string_view::npos);
+}
+
+TEST(strings, charset) {
+    const charset seps(" \t,;=");
+    EXPECT_EQ(str_split_any("a=1, b\t;c", seps),
+              (std::vector<std::string_view>{"a", "1", "", "b", "", "c"}));
+    EXPECT_EQ(str_split_any(" k = v ;x", ";=", true),
+              (std::vector<std::string_view>{"k", "v", "x"}));
+    EXPECT_EQ(str_split_any("", seps), (std::vector<std::string_view>{""}));
+    EXPECT_EQ(str_span("  \t,key", seps), 4);
+    EXPECT_EQ(str_span(", ;", seps), 3);
+    EXPECT_EQ(str_find_first_of("abc", seps), std::string_view::npos);
+    EXPECT_EQ(str_find_first_of("a b", seps, 3), std::string_view::npos);
+
+    // every byte value, against std::string_view over lengths crossing vectors
+    std::string set;
+    for (int c = 0; c < 256; c += 7) {
+        set.push_back((char)c);
+    }
+    const charset cs(set);
+    for (int c = 0; c < 256; ++c) {
+        EXPECT_EQ(cs.contains((char)c), set.find((char)c) != std::string::npos) << c;
+    }
+    std::string s;
+    for (size_t i = 0; i < 300; ++i) {
+        s.push_back((char)(i * 131 % 256 | 1));
+        const std::string_view v(s);
+        for (size_t pos : {(size_t)0, i / 2}) {
+            EXPECT_EQ(str_find_first_of(v, cs, pos), v.find_first_of(set, pos)) << i;
+            EXPECT_EQ(str_find_first_not_of(v, cs, pos), v.find_first_not_of(set, pos)) << i;
+        }
+    }
+    std::vector<std::string_view> fields;
+    str_split_any_into(s, cs, fields);
+    const std::string_view v(s);
+    size_t start = 0, end = 0;
+    for (auto f : fields) {
+        end = v.find_first_of(set, start);
+        EXPECT_EQ(f, v.substr(start, end - start)) << start;
+        start = end + 1;
+    }
+    EXPECT_EQ(end, std::string_view::npos);
+}
+
+TEST(strings, searcher) {
+    const searcher s("abc");
+    EXPECT_EQ(s.find("xxabcabc"), 2);
+    EXPECT_EQ(s.find("xxabcabc", 3), 5);
+    EXPECT_EQ(s.rfind("xxabcabc"), 5);
+    EXPECT_EQ(s.rfind("xxabcabc", 4), 2);
+    EXPECT_EQ(s.rfind("xxabcabc", 1), std::string_view::npos);
+    EXPECT_EQ(s.count("abcabcab"), 2);
+    EXPECT_EQ(searcher("aa").count("aaaaa"), 2);
+    EXPECT_EQ(searcher("").count("abc"), 4);
+    EXPECT_EQ(searcher("").rfind("abc"), 3);
+    EXPECT_EQ(s.find("ab"), std::string_view::npos);
+
+    // short (SIMD filter) and long (Raita) needles against std::string_view
+    std::string hay;
+    for (size_t i = 0; i < 3000; ++i) {
+        hay.push_back("abcab"[i * i % 5]);
+    }
+    std::vector<size_t> all;
+    for (size_t m : {1, 2, 5, 17, 63, 64, 65, 100, 300}) {
+        for (size_t at : {(size_t)0, (size_t)7, (size_t)1000, 2999 - m}) {
+            const std::string needle = hay.substr(at, m);
+            const searcher sr(needle);
+            const std::string_view h(hay);
+            EXPECT_EQ(sr.find(h), h.find(needle)) << m;
+            EXPECT_EQ(sr.find(h, at + 1), h.find(needle, at + 1)) << m;
+            EXPECT_EQ(sr.rfind(h), h.rfind(needle)) << m;
+            EXPECT_EQ(sr.rfind(h, at + 3), h.rfind(needle, at + 3)) << m;
+            std::vector<size_t> expected;
+            for (size_t p = h.find(needle); p != std::string_view::npos;
+                 p = h.find(needle, p + m)) {
+                expected.push_back(p);
+            }
+            EXPECT_EQ(sr.find_all(h, all), expected.size()) << m;
+            EXPECT_EQ(all, expected) << m;
+            EXPECT_EQ(sr.count(h), expected.size()) << m;
+        }
+    }
+}
+
+TEST(strings, multi_searcher) {
+    const multi_searcher ms({"error", "warn", "err", "fatal"});
+    std::vector<std::pair<size_t, size_t>> found;
+    ms.find_all("warn: error", [&](size_t id, size_t pos) { found.emplace_back(id, pos); });
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, (std::vector<std::pair<size_t, size_t>>{{0, 6}, {1, 0}, {2, 6}}));
+    EXPECT_TRUE(ms.contains_any("a fatal b"));
+    EXPECT_FALSE(ms.contains_any("all good"));
+    EXPECT_FALSE(multi_searcher({}).contains_any("abc"));
+    EXPECT_THROW(multi_searcher({"a", ""}), std::runtime_error);
+
+    // Teddy (small sets) and Aho-Corasick (large sets) against repeated finds,
+    // with duplicates, prefixes and overlaps
+    std::string hay;
+    for (size_t i = 0; i < 2000; ++i) {
+        hay.push_back("abcdxyz\x80"[i * i % 7 + (i % 97 == 0)]);
+    }
+    for (size_t npat : {1, 3, 8, 20, 64, 65, 300}) {
+        std::vector<std::string> pats;
+        for (size_t i = 0; i < npat; ++i) {
+            pats.push_back(hay.substr(i * 37 % 1900, 1 + i % 6 + (npat > 8)));
+        }
+        pats.push_back(pats.back());
+        const multi_searcher m(std::vector<std::string_view>(pats.begin(), pats.end()));
+        ASSERT_EQ(m.size(), pats.size());
+
+        std::vector<std::pair<size_t, size_t>> got, expected;
+        for (size_t id = 0; id < pats.size(); ++id) {
+            EXPECT_EQ(m.pattern(id), pats[id]);
+            for (size_t p = hay.find(pats[id]); p != std::string::npos;
+                 p = hay.find(pats[id], p + 1)) {
+                expected.emplace_back(id, p);
+            }
+        }
+        EXPECT_TRUE(m.find_all(hay, [&](size_t id, size_t pos) { got.emplace_back(id, pos); }));
+        std::sort(got.begin(), got.end());
+        EXPECT_EQ(got, expected) << npat;
+
+        size_t calls = 0;
+        EXPECT_FALSE(m.find_all(hay, [&](size_t, size_t) { return ++calls < 3; }));
+        EXPECT_EQ(calls, 3);
+    }
+}
+
+TEST(strings, icase) {
+    EXPECT_TRUE(str_iequals("Content-Type", "content-type"));
+    EXPECT_FALSE(str_iequals("Content-Type", "content-typ"));
+    EXPECT_FALSE(str_iequals("[", "{"));  // only letters fold
+    EXPECT_TRUE(str_iequals("", ""));
+    EXPECT_TRUE(str_istarts_with("X-Forwarded-For", "x-forwarded"));
+    EXPECT_FALSE(str_istarts_with("X-For", "x-forwarded"));
+    EXPECT_TRUE(str_iends_with("index.HTML", ".html"));
+    EXPECT_FALSE(str_iends_with("index.htm", ".html"));
+
+    std::string hay(300, 'a');
+    hay += "HeLLo World";
+    hay += std::string(70, 'b');
+    EXPECT_EQ(str_ifind(hay, "hello world"), 300);
+    EXPECT_EQ(str_ifind(hay, "HELLO WORLD", 300), 300);
+    EXPECT_EQ(str_ifind(hay, "hello world", 301), std::string_view::npos);
+    EXPECT_EQ(str_ifind(hay, "DB"), 310);
+    EXPECT_EQ(str_ifind(hay, "B"), 311);
+    EXPECT_EQ(str_ifind(hay, "bbbc"), std::string_view::npos);
+    EXPECT_EQ(str_ifind(hay, ""), 0);
+    EXPECT_EQ(str_ifind("abc", "abcd"), std::string_view::npos);
+    for (size_t i = 0; i + 5 <= hay.size(); i += 13) {
+        auto needle = hay.substr(i, 5);
+        EXPECT_EQ(str_ifind(hay, str_toupper(needle)), hay.find(needle)) << i;
+    }
+
+    EXPECT_EQ(str_ihash(str_toupper(hay)), str_ihash(hay));
+    EXPECT_NE(str_ihash(hay), str_ihash(hay.substr(1)));
+    EXPECT_NE(str_ihash("a"), str_ihash(std::string_view("a\0", 2)));
+    std::unordered_map<std::string, int, str_ihasher, str_iequal_to> headers;
+    headers["Content-Length"] = 1;
+    EXPECT_EQ(headers.count("CONTENT-LENGTH"), 1);
+}
+
+TEST(strings, active_target) {
+    const char* target = active_target();
+    ASSERT_NE(target, nullptr);
+    EXPECT_GT(strlen(target), 0);
+}
+
 TEST(strings, pack) {
     EXPECT_EQ(hex_encode(str_pack("i2", 1)), "0100");
 